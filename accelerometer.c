@@ -0,0 +1,75 @@
+/*
+ * accelerometer.c
+ *
+ *  Created on: Dec 14, 2016
+ *      Author: boer8364
+ */
+
+#include "accelerometer.h"
+
+#include "globalMacros.h"
+#include "hal.h"
+
+// Conversion memory slot i of the sample ring
+#define SAMPLE_RING_SLOT(i) Hal_adcSample(i)
+
+// Mid-scale of the 14-bit conversions, this is the 0g reading
+#define ADC_MID_SCALE 8192
+
+// Filter state in fixed point, with ACCELEROMETER_FILTER_FRACTION_BITS
+static int32_t filteredX;
+static int32_t filteredY;
+// The first read after a start loads the filter instead of filtering
+static uint8_t filterPrimed = 0;
+
+void Accelerometer_start() {
+    filterPrimed = 0;
+    Hal_adcStart();
+}
+
+void Accelerometer_stop() {
+    Hal_adcStop();
+}
+
+// Moves the filter state towards a new average
+static int32_t filter(int32_t state, int32_t average) {
+    return state + ((average - state) >> ACCELEROMETER_FILTER_SHIFT);
+}
+
+void Accelerometer_read(AccelerometerReading_t* reading) {
+    /* Sum the ring, even slots are x samples and odd slots are y samples,
+     * the ADC may overwrite a slot while this runs, which only swaps an old
+     * sample for a newer one */
+    int32_t sumX = 0;
+    int32_t sumY = 0;
+    uint8_t i = 0;
+    for(; i < ACCELEROMETER_RING_SIZE; i += 2) {
+        sumX += SAMPLE_RING_SLOT(i) & 0x3fff;
+        sumY += SAMPLE_RING_SLOT(i + 1) & 0x3fff;
+    }
+
+    // Average the samples into fixed point, centered on 0
+    int32_t averageX = (sumX << ACCELEROMETER_FILTER_FRACTION_BITS >>
+        ACCELEROMETER_SAMPLES_PER_AXIS_LOG2) -
+        (ADC_MID_SCALE << ACCELEROMETER_FILTER_FRACTION_BITS);
+    int32_t averageY = (sumY << ACCELEROMETER_FILTER_FRACTION_BITS >>
+        ACCELEROMETER_SAMPLES_PER_AXIS_LOG2) -
+        (ADC_MID_SCALE << ACCELEROMETER_FILTER_FRACTION_BITS);
+
+    if(filterPrimed) {
+        filteredX = filter(filteredX, averageX);
+        filteredY = filter(filteredY, averageY);
+    } else {
+        filteredX = averageX;
+        filteredY = averageY;
+        filterPrimed = 1;
+    }
+
+    // Round back to whole counts
+    reading->x = (int16_t)((filteredX +
+        (1 << (ACCELEROMETER_FILTER_FRACTION_BITS - 1))) >>
+        ACCELEROMETER_FILTER_FRACTION_BITS);
+    reading->y = (int16_t)((filteredY +
+        (1 << (ACCELEROMETER_FILTER_FRACTION_BITS - 1))) >>
+        ACCELEROMETER_FILTER_FRACTION_BITS);
+}
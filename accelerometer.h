@@ -0,0 +1,49 @@
+/*
+ * accelerometer.h
+ *
+ *  Created on: Dec 14, 2016
+ *      Author: boer8364
+ */
+
+#ifndef ACCELEROMETER_H_
+#define ACCELEROMETER_H_
+
+#include <inttypes.h>
+
+/* The ADC converts the x and y channels alternately, triggered by TIMER_A3,
+ * and writes them round-robin into its conversion memory without any
+ * interrupts, so the memory registers act as a ring of the latest samples */
+// Number of conversion memory registers used as the sample ring
+#define ACCELEROMETER_RING_SIZE 16
+// Number of samples of each axis in the ring
+#define ACCELEROMETER_SAMPLES_PER_AXIS (ACCELEROMETER_RING_SIZE / 2)
+// log2(ACCELEROMETER_SAMPLES_PER_AXIS), used to average the ring
+#define ACCELEROMETER_SAMPLES_PER_AXIS_LOG2 3
+// Conversion trigger period in ACLK cycles (about 1 kHz, 512 Hz per axis)
+#define ACCELEROMETER_TRIGGER_PERIOD 32
+
+/* Fractional bits kept by the filter, the oversampled average has more
+ * resolution than a single conversion */
+#define ACCELEROMETER_FILTER_FRACTION_BITS 4
+/* Strength of the first-order IIR filter applied on top of the average, each
+ * read moves the output 1 / 2^ACCELEROMETER_FILTER_SHIFT of the way to the
+ * new average, 0 disables it */
+#define ACCELEROMETER_FILTER_SHIFT 0
+
+// Filtered accelerometer reading, centered on 0
+typedef struct AccelerometerReading {
+    // X-axis reading
+    int16_t x;
+    // Y-axis reading
+    int16_t y;
+} AccelerometerReading_t;
+
+// Starts the conversion trigger timer and resets the filter
+void Accelerometer_start();
+// Stops the conversion trigger timer
+void Accelerometer_stop();
+/* Averages the sample ring and filters it, fills in the latest reading in
+ * whole ADC counts */
+void Accelerometer_read(AccelerometerReading_t* reading);
+
+#endif /* ACCELEROMETER_H_ */
@@ -0,0 +1,33 @@
+/*
+ * clock.c
+ *
+ *  Created on: Dec 24, 2016
+ *      Author: boer8364
+ */
+
+#include "clock.h"
+#include "hal.h"
+#include "profiler.h"
+
+/* The wait states follow the flash limits of system_msp432p401r.c, bank 0
+ * reads without wait states up to 12MHz at VCORE0 and up to 16MHz at VCORE1.
+ * SMCLK is kept at or below 24MHz, its limit at VCORE1, so the SPI bit clock
+ * is 12MHz on the screens and 24MHz in the game as before, and the ADC clock
+ * is 12MHz in both */
+const ClockProfile_t clockProfiles[CLOCK_PROFILE_COUNT] = {
+    {"menu", 12000000, 12000000, 3, 0, 0, 0, 0, 1, 1},
+    {"gameplay", 48000000, 24000000, 5, 1, 1, 2, 1, 1, 2}
+};
+
+ClockProfileId_t clockProfile = CLOCK_PROFILE_SCREENS;
+
+void Clock_setProfile(ClockProfileId_t id) {
+    if(id == clockProfile) {
+        return;
+    }
+    ClockProfileId_t previous = clockProfile;
+    Hal_clockApply(&clockProfiles[id]);
+    clockProfile = id;
+    // The time so far counts towards the frame rate of the previous profile
+    PROFILE_CLOCK_CHANGED(previous);
+}
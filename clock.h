@@ -0,0 +1,63 @@
+/*
+ * clock.h
+ *
+ *  Created on: Dec 24, 2016
+ *      Author: boer8364
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+/* Clock profiles, each one sets the DCO frequency together with what has to
+ * follow it: the core voltage and the flash wait states the frequency needs,
+ * and the dividers of the peripherals that run off SMCLK (the panel SPI and
+ * the ADC), so their clocks stay in spec in every profile. The UART and the
+ * timers run off ACLK (REFOCLK), which no profile touches, so the baud rate
+ * and the simulation clock do not change with the profile */
+typedef enum ClockProfileId {
+    // 12MHz at the low core voltage for the title and game over screens
+    CLOCK_PROFILE_MENU = 0,
+    // 48MHz for the game loop
+    CLOCK_PROFILE_GAMEPLAY,
+    // Number of profiles, not a profile
+    CLOCK_PROFILE_COUNT
+} ClockProfileId_t;
+
+// Profiles of the screens and of the game, swap them to compare frame rates
+#define CLOCK_PROFILE_SCREENS CLOCK_PROFILE_MENU
+#define CLOCK_PROFILE_GAME CLOCK_PROFILE_GAMEPLAY
+
+typedef struct ClockProfile {
+    const char* name;
+    // Resulting clock frequencies in Hz
+    uint32_t mclkFrequency;
+    uint32_t smclkFrequency;
+    // DCO frequency range (CS DCORSEL), 3 is 12MHz and 5 is 48MHz
+    uint8_t dcoRange;
+    // SMCLK divider from the DCO as a power of two (CS DIVS)
+    uint8_t smclkDividerLog2;
+    // Core voltage level of the LDO (PCM active mode), 0 or 1
+    uint8_t coreVoltage;
+    // Flash read wait states and whether the read buffers are on
+    uint8_t flashWaitStates;
+    uint8_t flashBuffering;
+    // Panel SPI bit clock divider from SMCLK
+    uint16_t spiDivider;
+    // ADC clock divider from SMCLK, 1 to 8
+    uint8_t adcDivider;
+} ClockProfile_t;
+
+// Every profile, indexed by ClockProfileId_t
+extern const ClockProfile_t clockProfiles[CLOCK_PROFILE_COUNT];
+/* Profile the clocks run in, Hal_init starts them in CLOCK_PROFILE_SCREENS
+ * and the HAL peripheral setup takes its dividers from here */
+extern ClockProfileId_t clockProfile;
+
+/* Switches the clocks to a profile and tells the profiler, it must not be
+ * called while a frame is being sent or the accelerometer is sampling */
+void Clock_setProfile(ClockProfileId_t id);
+
+#endif /* CLOCK_H_ */
@@ -7,7 +7,7 @@
 
 #include "collision.h"
 #include "lcdDriver.h"
-#include "msp.h"
+#include "counters.h"
 #include <math.h>
 #include <inttypes.h>
 
@@ -27,6 +27,60 @@ uint8_t angleWithinInterval(double angle, double startAngle, double endAngle) {
     }
 }
 
+/* Classifies a contact between the player and a wall whose current radius is
+ * wallRadius, playerPositionCenter is the player's position with respect to
+ * the center of the screen at the moment of contact */
+static CollisionCode_t classifyContact(Vector2d_t* playerPositionCenter,
+    double wallRadius, Wall_t* wall) {
+    // Check the angle of the player with respect to the center of the screen
+    double playerAngle = Vector2d_getDirection(playerPositionCenter);
+
+    uint8_t i;
+    for(i = 0; i < wall->numGaps; ++i) {
+        // Check if it is within this gap's angle interval
+        if(!angleWithinInterval(playerAngle, wall->gapStartAngle[i],
+            wall->gapEndAngle[i])) {
+            continue;
+        }
+
+        // These are the coordinates of the endpoints of the wall's gap
+        int16_t bX1 = (int16_t)(wallRadius *
+            COUNTED_COS(wall->gapStartAngle[i]));
+        int16_t bY1 = (int16_t)(wallRadius *
+            COUNTED_SIN(wall->gapStartAngle[i]));
+        int16_t bX2 = (int16_t)(wallRadius *
+            COUNTED_COS(wall->gapEndAngle[i]));
+        int16_t bY2 = (int16_t)(wallRadius *
+            COUNTED_SIN(wall->gapEndAngle[i]));
+
+        // Put them into vector structs
+        Vector2d_t gapStart = {bX1, bY1};
+        Vector2d_t gapEnd = {bX2, bY2};
+
+        /* Find the distances between the gap endpoints and the player's
+         * position by subtracting their position vectors and taking their
+         * magnitudes */
+        Vector2d_t gapStartDistanceV =
+            Vector2d_subtract(playerPositionCenter, &gapStart);
+        Vector2d_t gapEndDistanceV =
+            Vector2d_subtract(playerPositionCenter, &gapEnd);
+
+        double gapStartDistance = Vector2d_getMagnitude(&gapStartDistanceV);
+        double gapEndDistance = Vector2d_getMagnitude(&gapEndDistanceV);
+
+        /* If either distance is greater than the player radius, the
+         * player must be well within the wall gap, so the player breached
+         * the wall */
+        if(gapStartDistance > PLAYER_RADIUS &&
+            gapEndDistance > PLAYER_RADIUS) {
+            return GAP_COLLISION;
+        }
+    }
+    /* If the player's angle was not within any of the wall's gaps, it simply
+     * hit the surface of the wall */
+    return WALL_COLLISION;
+}
+
 CollisionCode_t collision(Player_t* player, Wall_t* wall) {
     // Position of the player with respect to the center of the screen
     Vector2d_t playerPositionCenter = Vector2d_subtract(&player->position,
@@ -37,48 +91,81 @@ CollisionCode_t collision(Player_t* player, Wall_t* wall) {
 
     // Check if the player's distance is at or past the wall's radius
     if(distance >= wall->radius - PLAYER_RADIUS - 1) {
-        // Check the angle of the player with respect to the center of the screen
-        double playerAngle = Vector2d_getDirection(&playerPositionCenter);
-        // Check if it is within the wall's gap angle interval
-        if(angleWithinInterval(playerAngle, wall->gapStartAngle, wall->gapEndAngle)) {
-            // These are the coordinates of the endpoints of the wall's gap
-            int16_t bX1 = (int16_t)(wall->radius * cos(wall->gapStartAngle));
-            int16_t bY1 = (int16_t)(wall->radius * sin(wall->gapStartAngle));
-            int16_t bX2 = (int16_t)(wall->radius * cos(wall->gapEndAngle));
-            int16_t bY2 = (int16_t)(wall->radius * sin(wall->gapEndAngle));
-
-            // Put them into vector structs
-            Vector2d_t gapStart = {bX1, bY1};
-            Vector2d_t gapEnd = {bX2, bY2};
-
-            /* Find the distances between the gap endpoints and the player's
-             * position by subtracting their position vectors and taking their
-             * magnitudes */
-            Vector2d_t gapStartDistanceV =
-                Vector2d_subtract(&playerPositionCenter, &gapStart);
-            Vector2d_t gapEndDistanceV =
-                Vector2d_subtract(&playerPositionCenter, &gapEnd);
-
-            double gapStartDistance = Vector2d_getMagnitude(&gapStartDistanceV);
-            double gapEndDistance = Vector2d_getMagnitude(&gapEndDistanceV);
-
-            /* If either distance is greater than the player radius, the
-             * player must be well within the wall gap, so the player breached
-             * the wall */
-            if(gapStartDistance > PLAYER_RADIUS &&
-                gapEndDistance > PLAYER_RADIUS) {
-                return GAP_COLLISION;
-            }
-        }
-        /* If the player's angle was not within the wall's gap, it simply hit
-         * the surface of the wall */
-        return WALL_COLLISION;
+        return classifyContact(&playerPositionCenter, wall->radius, wall);
     }
     /* If the player distance has not surpassed the wall radius, no collision
      * occurred */
     return NO_COLLISION;
 }
 
+CollisionCode_t sweptCollision(Player_t* player, Vector2d_t* movementVector,
+    Wall_t* wall, int16_t wallSpeed, double* timeOfImpact) {
+    COUNT_WORK(collisionChecks, 1);
+    // Position of the player with respect to the center of the screen
+    Vector2d_t playerPositionCenter = Vector2d_subtract(&player->position,
+        &SCREEN_CENTER);
+    // Distance from the center at which the player touches the wall
+    double contactDistance = wall->radius - PLAYER_RADIUS - 1;
+
+    /* If the player is already touching the wall, this is the same as a
+     * discrete check at the start of the frame */
+    if(Vector2d_getMagnitude(&playerPositionCenter) >= contactDistance) {
+        *timeOfImpact = 0.0;
+        return classifyContact(&playerPositionCenter, wall->radius, wall);
+    }
+
+    /* Over the frame (t in [0, 1]) the player is at p + v * t and the contact
+     * distance is c - s * t, so the time of impact is the first root of
+     * |p + v * t|^2 = (c - s * t)^2, which expands to the quadratic
+     * a * t^2 + b * t + k = 0 */
+    double a = Vector2d_dot(movementVector, movementVector) -
+        (double)wallSpeed * wallSpeed;
+    double b = 2.0 * (Vector2d_dot(&playerPositionCenter, movementVector) +
+        contactDistance * wallSpeed);
+    // k is always negative here since the player starts inside the wall
+    double k = Vector2d_dot(&playerPositionCenter, &playerPositionCenter) -
+        contactDistance * contactDistance;
+
+    // Time of impact, anything past 1 means no impact during this frame
+    double t = 2.0;
+    if(a == 0.0) {
+        // The equation is linear, it only has a root if the gap is closing
+        if(b > 0.0) {
+            t = -k / b;
+        }
+    } else {
+        double discriminant = b * b - 4.0 * a * k;
+        if(discriminant >= 0.0) {
+            double root = COUNTED_SQRT(discriminant);
+            double t0 = (-b - root) / (2.0 * a);
+            double t1 = (-b + root) / (2.0 * a);
+            // Take the earliest root that lies ahead in time
+            if(t0 >= 0.0 && t0 < t) {
+                t = t0;
+            }
+            if(t1 >= 0.0 && t1 < t) {
+                t = t1;
+            }
+        }
+    }
+
+    if(t > 1.0) {
+        // The player stays clear of the wall for the whole frame
+        *timeOfImpact = 1.0;
+        return NO_COLLISION;
+    }
+
+    *timeOfImpact = t;
+
+    /* Classify the contact using the player's position and the wall's radius
+     * at the moment of impact */
+    Vector2d_t contactPosition = *movementVector;
+    Vector2d_selfScale(&contactPosition, t);
+    Vector2d_selfAdd(&contactPosition, &playerPositionCenter);
+    return classifyContact(&contactPosition, wall->radius - wallSpeed * t,
+        wall);
+}
+
 Vector2d_t calculateNormalVector(Player_t* player, Vector2d_t* gravity, int16_t wallMovementSpeed) {
     // Get the position of the player with respect to the center of the screen
     Vector2d_t playerPositionCenter = Vector2d_subtract(&player->position,
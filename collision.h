@@ -31,6 +31,12 @@ uint8_t angleWithinInterval(double angle, double startAngle, double endAngle);
 /* Function that checks for a collision between a player and a wall and returns
  * the appropriate collision code */
 CollisionCode_t collision(Player_t* player, Wall_t* wall);
+/* Function that sweeps the player along movementVector over one frame while
+ * the wall closes in by wallSpeed, and returns the collision code at the
+ * earliest moment of contact, timeOfImpact is set to the fraction of the frame
+ * [0, 1] at which the contact happens (1 if there is no contact) */
+CollisionCode_t sweptCollision(Player_t* player, Vector2d_t* movementVector,
+    Wall_t* wall, int16_t wallSpeed, double* timeOfImpact);
 /* Function that calculates a normal vector that points toward the center of
  * the screen */
 Vector2d_t calculateNormalVector(Player_t* player, Vector2d_t* gravityVector, int16_t wallSpeed);
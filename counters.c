@@ -0,0 +1,111 @@
+/*
+ * counters.c
+ *
+ *  Created on: Dec 20, 2016
+ *      Author: boer8364
+ */
+
+#include "counters.h"
+
+#ifdef COUNTERS_DEBUG
+
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_COUNTERS
+#include "log.h"
+
+// The counters are all uint32_t, so the struct is walked as an array of them
+#define COUNTERS_FIELD_COUNT (sizeof(WorkCounters_t) / sizeof(uint32_t))
+
+WorkCounters_t workCounters;
+WorkCounters_t workCountersFrame;
+WorkCounters_t workCountersTotal;
+uint32_t workCountersFrames;
+
+// Names of the fields in the order of the struct
+static const char* const COUNTER_NAMES[] = {
+    "pixel",
+    "fill rect",
+    "line",
+    "line vertical",
+    "line horizontal",
+    "circle",
+    "fill circle",
+    "arc",
+    "clear",
+    "spi bytes",
+    "sqrt",
+    "atan2",
+    "sin",
+    "cos",
+    "walls drawn",
+    "collision checks",
+    "ticks"
+};
+
+// Sets every count in a set of counters to 0
+static void clear(WorkCounters_t* counters) {
+    uint32_t* fields = (uint32_t*)counters;
+    uint8_t i = 0;
+    for(; i < COUNTERS_FIELD_COUNT; ++i) {
+        fields[i] = 0;
+    }
+}
+
+void Counters_endFrame() {
+    const uint32_t* frame = (const uint32_t*)&workCounters;
+    uint32_t* total = (uint32_t*)&workCountersTotal;
+    uint8_t i = 0;
+    for(; i < COUNTERS_FIELD_COUNT; ++i) {
+        total[i] += frame[i];
+        if(frame[i]) {
+            LOG_DEBUG_VALUE(COUNTER_NAMES[i], frame[i]);
+        }
+    }
+    ++workCountersFrames;
+
+    workCountersFrame = workCounters;
+    clear(&workCounters);
+}
+
+void Counters_reset() {
+    clear(&workCounters);
+    clear(&workCountersFrame);
+    clear(&workCountersTotal);
+    workCountersFrames = 0;
+}
+
+void Counters_snapshot(WorkCounters_t* snapshot) {
+    *snapshot = workCountersFrame;
+}
+
+void Counters_report() {
+    if(!workCountersFrames) {
+        return;
+    }
+    const uint32_t* total = (const uint32_t*)&workCountersTotal;
+    uint8_t i = 0;
+    for(; i < COUNTERS_FIELD_COUNT; ++i) {
+        if(!total[i]) {
+            continue;
+        }
+#ifdef HOST_BUILD
+        printf("%-16s total %u per frame %.1f\n", COUNTER_NAMES[i], total[i],
+            (double)total[i] / workCountersFrames);
+#else
+        // Only the total, the average is the total over the frame count
+        LOG_INFO_VALUE(COUNTER_NAMES[i], total[i]);
+        LOG_FLUSH();
+#endif
+    }
+#ifdef HOST_BUILD
+    printf("%-16s %u\n", "frames", workCountersFrames);
+#else
+    LOG_INFO_VALUE("frames", workCountersFrames);
+    LOG_FLUSH();
+#endif
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * counters.h
+ *
+ *  Created on: Dec 20, 2016
+ *      Author: boer8364
+ */
+
+#ifndef COUNTERS_H_
+#define COUNTERS_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+/* Work counters, a hardware independent cost model of a frame: how many
+ * pixels each drawing primitive wrote, how many bytes went to the panel, how
+ * many transcendental calls the math made and how many walls were handled.
+ * Unlike the profiler the counts come out the same on every machine, so a
+ * replayed run shows a rendering or math regression as a changed count */
+typedef enum CountersPrimitive {
+    COUNTERS_PRIMITIVE_PIXEL = 0,
+    COUNTERS_PRIMITIVE_FILL_RECT,
+    /* LCD_drawLine hands vertical and horizontal lines to the dedicated
+     * functions, those are counted there */
+    COUNTERS_PRIMITIVE_LINE,
+    COUNTERS_PRIMITIVE_LINE_VERTICAL,
+    COUNTERS_PRIMITIVE_LINE_HORIZONTAL,
+    COUNTERS_PRIMITIVE_CIRCLE,
+    COUNTERS_PRIMITIVE_FILL_CIRCLE,
+    COUNTERS_PRIMITIVE_ARC,
+    // Clearing the frame buffer to the background color
+    COUNTERS_PRIMITIVE_CLEAR,
+    // Number of primitives, not a primitive
+    COUNTERS_PRIMITIVE_COUNT
+} CountersPrimitive_t;
+
+typedef struct WorkCounters {
+    // Pixels written by each primitive
+    uint32_t pixels[COUNTERS_PRIMITIVE_COUNT];
+    // Bytes sent to the panel, commands included
+    uint32_t spiBytes;
+    // Math library calls
+    uint32_t sqrtCalls;
+    uint32_t atan2Calls;
+    uint32_t sinCalls;
+    uint32_t cosCalls;
+    // Walls drawn, the boundary not included
+    uint32_t wallsDrawn;
+    // Swept collision checks against a wall or the boundary
+    uint32_t collisionChecks;
+    // Simulation ticks run
+    uint32_t ticks;
+} WorkCounters_t;
+
+#ifdef COUNTERS_DEBUG
+
+// Counts of the frame in progress
+extern WorkCounters_t workCounters;
+// Counts of the last complete frame
+extern WorkCounters_t workCountersFrame;
+// Counts summed over every frame since the last reset
+extern WorkCounters_t workCountersTotal;
+// Number of frames in workCountersTotal
+extern uint32_t workCountersFrames;
+
+/* Ends a frame, the counts in progress move to workCountersFrame and are
+ * added to the total, they are logged at the debug level */
+void Counters_endFrame();
+// Clears every count
+void Counters_reset();
+// Copies the counts of the last complete frame
+void Counters_snapshot(WorkCounters_t* snapshot);
+/* Reports the totals and the frame count, through the logger on the target
+ * and to stdout, along with the per-frame averages, on the host */
+void Counters_report();
+
+#define COUNT_WORK(counter, n) (workCounters.counter += (n))
+#define COUNT_PIXELS(primitive, n) (workCounters.pixels[(primitive)] += (n))
+#define COUNTERS_END_FRAME() Counters_endFrame()
+#define COUNTERS_RESET() Counters_reset()
+#define COUNTERS_REPORT() Counters_report()
+#else
+// Compiled out, none of these generate any code
+#define COUNT_WORK(counter, n) ((void)0)
+#define COUNT_PIXELS(primitive, n) ((void)0)
+#define COUNTERS_END_FRAME() ((void)0)
+#define COUNTERS_RESET() ((void)0)
+#define COUNTERS_REPORT() ((void)0)
+#endif
+
+// Math library calls that count themselves
+#define COUNTED_SQRT(x) (COUNT_WORK(sqrtCalls, 1), sqrt(x))
+#define COUNTED_ATAN2(y, x) (COUNT_WORK(atan2Calls, 1), atan2((y), (x)))
+#define COUNTED_SIN(x) (COUNT_WORK(sinCalls, 1), sin(x))
+#define COUNTED_COS(x) (COUNT_WORK(cosCalls, 1), cos(x))
+
+#endif /* COUNTERS_H_ */
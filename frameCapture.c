@@ -0,0 +1,136 @@
+/*
+ * frameCapture.c
+ *
+ *  Created on: Dec 22, 2016
+ *      Author: boer8364
+ */
+
+#include "frameCapture.h"
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "lcdDriver.h"
+#include "simClock.h"
+
+#define CAPTURE_PIXELS (LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT)
+
+static uint8_t capturing = 0;
+static CaptureFormat_t format;
+// Stream the frames go to, unused for a sequence
+static FILE* file;
+// printf format of the sequence file names
+static const char* sequencePath;
+static uint32_t frames;
+
+// A whole converted frame, written with a single fwrite
+static uint8_t frameBytes[3 * CAPTURE_PIXELS];
+
+// Widens an RGB565 pixel to 8 bits per channel, repeating the top bits
+static void toRgb(uint16_t pixel, uint8_t* rgb) {
+    uint8_t r = pixel >> 11;
+    uint8_t g = (pixel >> 5) & 0x3f;
+    uint8_t b = pixel & 0x1f;
+    rgb[0] = (uint8_t)((r << 3) | (r >> 2));
+    rgb[1] = (uint8_t)((g << 2) | (g >> 4));
+    rgb[2] = (uint8_t)((b << 3) | (b >> 2));
+}
+
+static void writePpmHeader(FILE* out) {
+    fprintf(out, "P6\n%u %u\n255\n", LCD_SCREEN_WIDTH, LCD_SCREEN_HEIGHT);
+}
+
+static void writePpm(FILE* out, const uint16_t* pixels) {
+    uint32_t i = 0;
+    for(; i < CAPTURE_PIXELS; ++i) {
+        toRgb(pixels[i], &frameBytes[3 * i]);
+    }
+    writePpmHeader(out);
+    fwrite(frameBytes, 1, sizeof(frameBytes), out);
+}
+
+// Clamps a chroma value, saturated colors land just outside 0 to 255
+static uint8_t clampChroma(int32_t value) {
+    return (uint8_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+/* Writes a Y4M frame, the planes are full resolution full range BT.601 in
+ * integer math */
+static void writeY4m(FILE* out, const uint16_t* pixels) {
+    uint8_t* y = frameBytes;
+    uint8_t* u = frameBytes + CAPTURE_PIXELS;
+    uint8_t* v = frameBytes + 2 * CAPTURE_PIXELS;
+    uint32_t i = 0;
+    for(; i < CAPTURE_PIXELS; ++i) {
+        uint8_t rgb[3];
+        toRgb(pixels[i], rgb);
+        int32_t r = rgb[0];
+        int32_t g = rgb[1];
+        int32_t b = rgb[2];
+        y[i] = (uint8_t)((77 * r + 150 * g + 29 * b + 128) >> 8);
+        u[i] = clampChroma((-43 * r - 85 * g + 128 * b + 32768 + 128) >> 8);
+        v[i] = clampChroma((128 * r - 107 * g - 21 * b + 32768 + 128) >> 8);
+    }
+    fputs("FRAME\n", out);
+    fwrite(frameBytes, 1, sizeof(frameBytes), out);
+}
+
+uint8_t FrameCapture_open(const char* path) {
+    frames = 0;
+    format = FrameCapture_format(path);
+    if(format == CAPTURE_FORMAT_PPM_SEQUENCE) {
+        sequencePath = path;
+        capturing = 1;
+        return 1;
+    }
+
+    file = fopen(path, "wb");
+    if(!file) {
+        return 0;
+    }
+    // Big writes, a frame is 48 KB
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+    if(format == CAPTURE_FORMAT_Y4M) {
+        // The panel is sent at most once per simulation tick
+        fprintf(file,
+            "YUV4MPEG2 W%u H%u F%u:%u Ip A1:1 C444 XCOLORRANGE=FULL\n",
+            LCD_SCREEN_WIDTH, LCD_SCREEN_HEIGHT, SIM_CLOCK_FREQUENCY,
+            SIM_TICK_PERIOD);
+    }
+    capturing = 1;
+    return 1;
+}
+
+void FrameCapture_frame(const uint16_t* pixels) {
+    if(!capturing) {
+        return;
+    }
+    if(format == CAPTURE_FORMAT_PPM_SEQUENCE) {
+        char name[256];
+        snprintf(name, sizeof(name), sequencePath, frames);
+        FILE* out = fopen(name, "wb");
+        if(!out) {
+            fprintf(stderr, "Can not write %s\n", name);
+            capturing = 0;
+            return;
+        }
+        writePpm(out, pixels);
+        fclose(out);
+    } else if(format == CAPTURE_FORMAT_Y4M) {
+        writeY4m(file, pixels);
+    } else {
+        writePpm(file, pixels);
+    }
+    ++frames;
+}
+
+uint32_t FrameCapture_close() {
+    if(capturing && format != CAPTURE_FORMAT_PPM_SEQUENCE) {
+        fclose(file);
+    }
+    capturing = 0;
+    return frames;
+}
+
+#endif
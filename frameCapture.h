@@ -0,0 +1,57 @@
+/*
+ * frameCapture.h
+ *
+ *  Created on: Dec 22, 2016
+ *      Author: boer8364
+ */
+
+#ifndef FRAMECAPTURE_H_
+#define FRAMECAPTURE_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+#ifdef HOST_BUILD
+
+#include <string.h>
+
+/* Host capture of the frames the panel receives, the host panel model hands
+ * over every complete frame, drawn into pixelBuffer or sent with
+ * LCD_sendCustomBuffer alike. The format follows the path:
+ *
+ *   name.y4m      one YUV4MPEG2 stream, 4:4:4, for video players
+ *   name%05u.ppm  one binary PPM per frame, the path is a printf format
+ *   name.ppm      every frame as one binary PPM after another in one file
+ *
+ * The PPMs are exact, RGB565 widened to 8 bits per channel, which is what
+ * tools/frameDiff.c compares to find pixel differences between two builds
+ * replaying the same input. The Y4M colors go through a YUV conversion */
+
+typedef enum CaptureFormat {
+    CAPTURE_FORMAT_PPM_STREAM = 0,
+    CAPTURE_FORMAT_PPM_SEQUENCE,
+    CAPTURE_FORMAT_Y4M
+} CaptureFormat_t;
+
+/* Format of the capture at path as listed above, shared with the tools that
+ * read captures back */
+static inline CaptureFormat_t FrameCapture_format(const char* path) {
+    size_t length = strlen(path);
+    if(strchr(path, '%')) {
+        return CAPTURE_FORMAT_PPM_SEQUENCE;
+    }
+    return length >= 4 && !strcmp(path + length - 4, ".y4m") ?
+        CAPTURE_FORMAT_Y4M : CAPTURE_FORMAT_PPM_STREAM;
+}
+
+/* Opens a capture, returns 0 if the file could not be created, frames are
+ * dropped while no capture is open */
+uint8_t FrameCapture_open(const char* path);
+// Adds a frame of LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT RGB565 pixels
+void FrameCapture_frame(const uint16_t* pixels);
+// Flushes and closes the capture, returns the number of frames captured
+uint32_t FrameCapture_close();
+
+#endif
+
+#endif /* FRAMECAPTURE_H_ */
@@ -12,6 +12,71 @@
 
 // Debug flags
 //#define UART_DEBUG
-//#define TIMING_INFO_DEBUG
+/* Binary event trace over the UART, needs UART_DEBUG, decode the captured
+ * stream with tools/traceDecode.c */
+//#define TRACE_DEBUG
+/* Trace-only mode, events and log messages are recorded into a RAM ring for
+ * the debugger instead of going out over the UART, this is cheap enough to
+ * leave on, log levels are set per module in log.h */
+//#define TRACE_RAM
+// Per-zone cycle profiler, the report goes out over the UART with UART_DEBUG
+//#define PROFILE_DEBUG
+// Per-frame work counters (pixels, SPI bytes, math calls), see counters.h
+//#define COUNTERS_DEBUG
+/* Per-pixel write counts of every frame, summarized as a histogram of the
+ * overdraw, see overdraw.h, this takes 16 KB of RAM */
+//#define OVERDRAW_DEBUG
+/* Input record and replay, the target plays back the stream in
+ * replayStream.c, or records into replayBuffer when it is empty */
+//#define INPUT_REPLAY
+/* Runs the lcdDriver microbenchmarks once before the title screen, the
+ * results go out over the UART with UART_DEBUG, see lcdBenchmark.h */
+//#define LCD_BENCHMARK
+
+/* Host (Linux) build flag, this is passed in by the host build rather than
+ * defined here, modules swap their hardware access for host stand-ins */
+//#define HOST_BUILD
+
+// Global interrupt masking, the host build has no interrupts to mask
+#ifdef HOST_BUILD
+#define DISABLE_INTERRUPTS()
+#define ENABLE_INTERRUPTS()
+#else
+#define DISABLE_INTERRUPTS() __disable_interrupt()
+#define ENABLE_INTERRUPTS() __enable_interrupt()
+#endif
+
+/* Memory barrier used when handing data between an ISR and the game loop,
+ * it keeps both the compiler and the CPU from reordering memory accesses
+ * across it */
+#ifdef HOST_BUILD
+#define MEMORY_BARRIER() __sync_synchronize()
+#else
+#define MEMORY_BARRIER() __DMB()
+#endif
+
+/* The hottest functions are marked RAMFUNC, the start-up code copies them
+ * from flash into SRAM and they run from there without the flash wait states,
+ * see the .TI.ramfunc section in msp432p401r.cmd. RAMFUNC_DISABLE leaves
+ * them in flash, comparing the lcdDriver benchmarks of the two builds with
+ * tools/benchCompare.c shows what SRAM execution gains */
+//#define RAMFUNC_DISABLE
+#if defined(HOST_BUILD) || defined(RAMFUNC_DISABLE)
+#define RAMFUNC
+#else
+#define RAMFUNC __attribute__((ramfunc))
+#endif
+
+/* Static placement of the big buffers, the target puts them in named sections
+ * that msp432p401r.cmd places and tools/memReport.c reports on. Named
+ * sections are not zero-initialized at start-up, so whatever goes in them
+ * must be written before it is read. The host leaves the placement to the
+ * linker */
+#ifdef HOST_BUILD
+#define MEMORY_SECTION(name)
+#else
+#define MEMORY_SECTION(name) __attribute__((section(name)))
+#endif
+#define MEMORY_ALIGN(bytes) __attribute__((aligned(bytes)))
 
 #endif /* GLOBALMACROS_H_ */
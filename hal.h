@@ -0,0 +1,181 @@
+/*
+ * hal.h
+ *
+ *  Created on: Dec 4, 2016
+ *      Author: boer8364
+ */
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+#include "clock.h"
+
+#ifndef HOST_BUILD
+#include "msp.h"
+#endif
+
+/* Hardware abstraction layer, the game only touches the board through these
+ * calls. halMsp432.c implements them on the MSP432 and halHost.c on Linux,
+ * where the same game code runs headless. The calls made once per byte or per
+ * sample are inlined here on the target so that they cost what the register
+ * accesses did */
+
+// Flag that determines if the start/stop button was pressed
+extern volatile uint8_t buttonPressed;
+
+/* ***** System ***** */
+
+/* Stops the watchdog, sets up the clocks in the clockProfile profile and
+ * starts the cycle counter, MCLK and SMCLK run off the DCO and ACLK runs off
+ * REFOCLK (32.768kHz) */
+void Hal_init();
+
+/* Switches the clocks to a profile, raising the core voltage and the flash
+ * wait states before the DCO speeds up and lowering them after it slows
+ * down, and sets the SPI and ADC dividers of the profile. The SPI finishes
+ * the byte in flight first, the ADC must be stopped */
+void Hal_clockApply(const ClockProfile_t* profile);
+
+/* Sleeps until the next interrupt, deep selects LPM3 instead of LPM0, it must
+ * be called with interrupts disabled */
+void Hal_waitForInterrupt(uint8_t deep);
+
+// Busy-waits for a number of MCLK cycles, the count must be a constant
+#ifdef HOST_BUILD
+#define HAL_DELAY_CYCLES(cycles) ((void)0)
+#else
+#define HAL_DELAY_CYCLES(cycles) __delay_cycles(cycles)
+#endif
+
+/* Starts the free-running cycle counter, it counts MCLK cycles on the target
+ * and nanoseconds on the host, the count is not reset so that it can time
+ * the boot across the calls */
+void Hal_cycleCounterInit();
+
+/* Converts a number of cycle counter ticks to microseconds and back, at the
+ * MCLK of the current clock profile */
+#ifdef HOST_BUILD
+#define HAL_CYCLES_TO_US(cycles) ((cycles) / 1000)
+#define HAL_US_TO_CYCLES(us) ((us) * 1000)
+#else
+#define HAL_CYCLES_TO_US(cycles) \
+    ((cycles) / (clockProfiles[clockProfile].mclkFrequency / 1000000))
+#define HAL_US_TO_CYCLES(us) \
+    ((us) * (clockProfiles[clockProfile].mclkFrequency / 1000000))
+#endif
+
+#ifdef HOST_BUILD
+uint32_t Hal_cycleCount();
+#else
+static inline uint32_t Hal_cycleCount() {
+    return DWT->CYCCNT;
+}
+#endif
+
+/* ***** LCD panel, 3-wire SPI plus the reset, chip select and command/data
+ * select lines ***** */
+
+// Configures the SPI bus and the control lines
+void Hal_panelInit();
+// Holds the panel controller in reset while asserted is set
+void Hal_panelSetReset(uint8_t asserted);
+// Selects the panel controller on the bus while selected is set
+void Hal_panelSelect(uint8_t selected);
+
+#ifdef HOST_BUILD
+void Hal_panelWriteCommand(uint8_t cmd);
+void Hal_panelWriteData(uint8_t data);
+#else
+// Sends a byte, blocks until the SPI transmitter is ready for it
+static inline void Hal_panelSendByte(uint8_t byte) {
+    while(UCB0STATW & UCBUSY);
+    UCB0TXBUF = byte;
+}
+
+// Sends a command byte, the DC line (P3.7) is low for commands
+static inline void Hal_panelWriteCommand(uint8_t cmd) {
+    P3OUT &= ~BIT7;
+    Hal_panelSendByte(cmd);
+    P3OUT |= BIT7;
+}
+
+// Sends a data byte
+static inline void Hal_panelWriteData(uint8_t data) {
+    Hal_panelSendByte(data);
+}
+#endif
+
+/* ***** Simulation clock timer, free-running on ACLK, interrupts once per
+ * simulation tick and once per overflow ***** */
+
+void Hal_simTimerInit();
+// Returns the 32-bit simulation timestamp in ACLK cycles
+uint32_t Hal_simTimerNow();
+
+/* ***** Accelerometer ADC, converts the x and y channels alternately into a
+ * ring of conversion memory slots, paced by a trigger timer ***** */
+
+void Hal_adcInit();
+// Starts and stops the conversion triggers
+void Hal_adcStart();
+void Hal_adcStop();
+
+#ifdef HOST_BUILD
+uint16_t Hal_adcSample(uint8_t slot);
+#else
+// Returns the last conversion in the given slot of the ring
+static inline uint16_t Hal_adcSample(uint8_t slot) {
+    return ADC14->MEM[slot];
+}
+#endif
+
+/* ***** Start/stop button, interrupts on a press ***** */
+
+void Hal_buttonInit();
+// Enables the press interrupt and clears buttonPressed
+void Hal_buttonEnable();
+void Hal_buttonDisable();
+
+/* ***** Debug UART, 9600 baud through USB ***** */
+
+#ifdef UART_DEBUG
+void Hal_uartInit();
+#endif
+
+#ifdef HOST_BUILD
+// The host drains the logger itself while it sleeps
+static inline void Hal_uartKick() {
+}
+// The host line has nothing in flight once a byte left the logger buffer
+static inline uint8_t Hal_uartBusy() {
+    return 0;
+}
+#else
+// Turns on the TX interrupt so that it drains the logger buffer
+static inline void Hal_uartKick() {
+    EUSCI_A0->IE |= EUSCI_A_IE_TXIE;
+}
+/* Whether a byte is still in TXBUF or the shift register, the last one takes
+ * about 1ms at 9600 baud after the logger buffer is empty */
+static inline uint8_t Hal_uartBusy() {
+    return EUSCI_A0->STATW & EUSCI_A_STATW_BUSY;
+}
+#endif
+
+#ifdef HOST_BUILD
+/* ***** Host only ***** */
+
+// Image the host panel shows, in the order the pixels were written
+extern uint16_t halHostPanel[];
+// Number of complete frames written to the host panel
+extern uint32_t halHostPanelFrames;
+// Number of bytes sent to the host panel
+extern uint32_t halHostSpiBytes;
+
+// Writes a conversion into the next slot of the host sample ring
+void Hal_hostAdcPush(uint16_t rawSample);
+#endif
+
+#endif /* HAL_H_ */
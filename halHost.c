@@ -0,0 +1,384 @@
+/*
+ * halHost.c
+ *
+ *  Created on: Dec 18, 2016
+ *      Author: boer8364
+ *
+ * Linux implementation of the hardware abstraction layer, the game runs
+ * headless on it as fast as the host allows. Time is virtual: the simulation
+ * clock only moves while the game sleeps, and each sleep jumps straight to
+ * the next simulation tick, so every frame simulates exactly one tick no
+ * matter how long it took to draw. The accelerometer follows a scripted
+ * tilt, the button is pressed as soon as the game waits for it, and the panel
+ * decodes the SPI stream into an image. After HOST_FRAMES frames (from the
+ * environment, 2000 by default) have been sent to the panel, the frame rate
+ * and the profiler and work counter reports are printed and the program
+ * exits. With
+ * INPUT_REPLAY, HOST_REPLAY names a recording to play back instead of the
+ * scripted input, the program then exits at the end of the recording, and
+ * HOST_RECORD names a file to save the recording of the run to. With
+ * OVERDRAW_DEBUG, HOST_OVERDRAW names a PPM file to save the overdraw map of
+ * the worst frame of the last game to. HOST_CAPTURE names a file to capture
+ * every frame the panel receives to, see frameCapture.h for the formats.
+ * With UART_DEBUG, HOST_UART names a file to save everything the debug UART
+ * sent to, the log text and the trace records. Build it with the Makefile.
+ */
+
+#include "globalMacros.h"
+
+#ifdef HOST_BUILD
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hal.h"
+#include "simClock.h"
+#include "accelerometer.h"
+#include "lcdDriver.h"
+#include "uartLogger.h"
+#include "profiler.h"
+#include "counters.h"
+#include "replay.h"
+#include "overdraw.h"
+#include "frameCapture.h"
+
+// Frames to run when HOST_FRAMES is not set
+#define HOST_DEFAULT_FRAMES 2000
+
+/* Scripted tilt, each axis swings sinusoidally around mid-scale with its own
+ * period (in ACLK cycles) so that the player wanders around the screen */
+#define HOST_TILT_MID_SCALE 8192
+#define HOST_TILT_AMPLITUDE 2500
+#define HOST_TILT_PERIOD_X (SIM_CLOCK_FREQUENCY * 31 / 10)
+#define HOST_TILT_PERIOD_Y (SIM_CLOCK_FREQUENCY * 47 / 10)
+
+// The debug UART sends 960 bytes per second (9600 baud, 10 bits per byte)
+#define HOST_UART_BYTES_PER_SECOND 960
+
+volatile uint8_t buttonPressed = 0;
+
+uint16_t halHostPanel[LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT];
+uint32_t halHostPanelFrames = 0;
+uint32_t halHostSpiBytes = 0;
+
+// Frames to run before exiting
+static uint32_t frameLimit;
+// Real time at start-up, in nanoseconds
+static uint32_t startTime;
+// Number of games started, the button is disabled at the start of each
+static uint32_t games = 0;
+
+// Virtual ACLK count and the time of the next simulation tick
+static uint32_t aclk = 0;
+static uint32_t nextTick = SIM_TICK_PERIOD;
+static uint8_t simTimerRunning = 0;
+
+// Conversion triggers, the ring of conversion memory and its next slot
+static uint8_t adcRunning = 0;
+static uint32_t nextConversion;
+static volatile uint16_t adcRing[ACCELEROMETER_RING_SIZE];
+static uint8_t adcSlot = 0;
+
+static uint8_t buttonEnabled = 0;
+
+// Panel state, the last command and the number of data bytes after it
+static uint8_t panelSelected = 0;
+static uint8_t panelCommand = 0;
+static uint32_t panelDataBytes = 0;
+
+#ifdef UART_DEBUG
+// Bytes per second times ACLK cycles the line has not used yet
+static uint32_t uartCredit = 0;
+
+/* Saves what the UART sent to HOST_UART, the bytes still queued are sent
+ * first as the line would have */
+static void finishUart() {
+    const char* uartPath = getenv("HOST_UART");
+    if(!uartPath) {
+        return;
+    }
+    UART_Logger_hostTransmit(UINT32_MAX);
+    FILE* file = fopen(uartPath, "wb");
+    if(!file || fwrite(uartLoggerHostCapture, 1, uartLoggerHostCaptureLength,
+        file) != uartLoggerHostCaptureLength) {
+        fprintf(stderr, "Can not write %s\n", uartPath);
+    }
+    if(file) {
+        fclose(file);
+    }
+    if(uartLoggerHostCaptureLength == UART_LOGGER_HOST_CAPTURE_SIZE) {
+        fprintf(stderr, "%s: capture full, the rest was not saved\n",
+            uartPath);
+    }
+}
+#endif
+
+#ifdef INPUT_REPLAY
+// Recording to save at exit, NULL when not recording
+static const char* recordPath = NULL;
+
+// Loads HOST_REPLAY for playback or starts recording for HOST_RECORD
+static void startReplay() {
+    const char* replayPath = getenv("HOST_REPLAY");
+    recordPath = getenv("HOST_RECORD");
+    if(replayPath) {
+        FILE* file = fopen(replayPath, "rb");
+        if(!file) {
+            fprintf(stderr, "Can not open %s\n", replayPath);
+            exit(1);
+        }
+        static uint8_t stream[REPLAY_BUFFER_SIZE];
+        uint32_t length = (uint32_t)fread(stream, 1, sizeof(stream), file);
+        fclose(file);
+        Replay_startPlayback(stream, length);
+        // The playback decides how long the run is
+        frameLimit = UINT32_MAX;
+        recordPath = NULL;
+    } else if(recordPath) {
+        Replay_startRecording();
+    }
+}
+
+// Saves the recording and reports how the playback went
+static void finishReplay() {
+    if(recordPath) {
+        FILE* file = fopen(recordPath, "wb");
+        if(!file || fwrite(replayBuffer, 1, replayLength + 1, file) !=
+            replayLength + 1) {
+            fprintf(stderr, "Can not write %s\n", recordPath);
+        }
+        if(file) {
+            fclose(file);
+        }
+    }
+    if(replayMode != REPLAY_MODE_OFF) {
+        printf("replay: %u games, %u ticks, %u mismatches%s\n",
+            replayStats.games, replayStats.ticks, replayStats.mismatches,
+            replayStats.truncated ? ", truncated" : "");
+    }
+}
+#endif
+
+// Prints the zone timings and the frame rate, then exits
+static void finish() {
+    double seconds = (uint32_t)(Hal_cycleCount() - startTime) / 1e9;
+    PROFILE_REPORT();
+    COUNTERS_REPORT();
+    OVERDRAW_REPORT();
+#ifdef OVERDRAW_DEBUG
+    const char* overdrawPath = getenv("HOST_OVERDRAW");
+    if(overdrawPath && !Overdraw_writeImage(overdrawPath, overdrawWorstCount)) {
+        fprintf(stderr, "Can not write %s\n", overdrawPath);
+    }
+#endif
+#ifdef UART_DEBUG
+    finishUart();
+#endif
+    uint32_t captured = FrameCapture_close();
+    if(captured) {
+        printf("%u frames captured\n", captured);
+    }
+    printf("%u frames, %u games, %.3f s, %.1f fps, %.1fx real time\n",
+        halHostPanelFrames, games, seconds, halHostPanelFrames / seconds,
+        (double)aclk / SIM_CLOCK_FREQUENCY / seconds);
+#ifdef INPUT_REPLAY
+    finishReplay();
+    exit(replayStats.mismatches || replayStats.truncated);
+#else
+    exit(0);
+#endif
+}
+
+// Runs the conversions triggered up to the current time
+static void convert() {
+    while(adcRunning && (int32_t)(aclk - nextConversion) >= 0) {
+        // The even slots convert x and the odd slots convert y
+        uint32_t period = (adcSlot & 1) ? HOST_TILT_PERIOD_Y :
+            HOST_TILT_PERIOD_X;
+        double phase = 2.0 * CONSTANT_PI * (nextConversion % period) / period;
+        Hal_hostAdcPush((uint16_t)(HOST_TILT_MID_SCALE +
+            HOST_TILT_AMPLITUDE * sin(phase)));
+        nextConversion += ACCELEROMETER_TRIGGER_PERIOD;
+    }
+}
+
+void Hal_init() {
+    const char* frames = getenv("HOST_FRAMES");
+    frameLimit = frames ? (uint32_t)strtoul(frames, NULL, 10) :
+        HOST_DEFAULT_FRAMES;
+    const char* capturePath = getenv("HOST_CAPTURE");
+    if(capturePath && !FrameCapture_open(capturePath)) {
+        fprintf(stderr, "Can not write %s\n", capturePath);
+        exit(1);
+    }
+    startTime = Hal_cycleCount();
+#ifdef INPUT_REPLAY
+    startReplay();
+#endif
+}
+
+void Hal_clockApply(const ClockProfile_t* profile) {
+    /* The host runs at its own speed in every profile, only the order the
+     * game switches in is checked */
+    (void)profile;
+    if(adcRunning) {
+        fprintf(stderr, "Clock switch with the ADC running\n");
+        exit(1);
+    }
+}
+
+void Hal_waitForInterrupt(uint8_t deep) {
+    if(halHostPanelFrames >= frameLimit) {
+        finish();
+    }
+#ifdef INPUT_REPLAY
+    // The run ends with the playback, which may be in the middle of a game
+    if(Replay_finished()) {
+        finish();
+    }
+#endif
+
+    if(deep) {
+        // Only the button wakes the CPU from LPM3
+        if(!buttonEnabled) {
+            fprintf(stderr, "Deep sleep with the button disabled\n");
+            exit(1);
+        }
+        buttonPressed = 1;
+        return;
+    }
+
+    if(!simTimerRunning) {
+        fprintf(stderr, "Sleep with the simulation timer stopped\n");
+        exit(1);
+    }
+
+    // Skip ahead to the next tick, converting and transmitting on the way
+    uint32_t elapsed = nextTick - aclk;
+    aclk = nextTick;
+    nextTick += SIM_TICK_PERIOD;
+    convert();
+#ifdef UART_DEBUG
+    uartCredit += elapsed * HOST_UART_BYTES_PER_SECOND;
+    uartCredit -= UART_Logger_hostTransmit(uartCredit / SIM_CLOCK_FREQUENCY) *
+        SIM_CLOCK_FREQUENCY;
+    // An idle line does not save up bytes
+    if(uartCredit > SIM_CLOCK_FREQUENCY) {
+        uartCredit = SIM_CLOCK_FREQUENCY;
+    }
+#else
+    (void)elapsed;
+#endif
+    // What simTimerISR does, timed in its zone so the host reports it too
+    PROFILE_BEGIN(PROFILE_ZONE_ISR_SIM_TIMER);
+    ++simTicksPending;
+    PROFILE_END(PROFILE_ZONE_ISR_SIM_TIMER);
+    // A screen waiting in LPM0 gets its button press a tick later
+    if(buttonEnabled) {
+        buttonPressed = 1;
+    }
+}
+
+void Hal_cycleCounterInit() {
+}
+
+uint32_t Hal_cycleCount() {
+    // Monotonic clock in nanoseconds, truncated to 32 bits
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000 + now.tv_nsec);
+}
+
+void Hal_panelInit() {
+}
+
+void Hal_panelSetReset(uint8_t asserted) {
+    if(asserted) {
+        panelCommand = 0;
+        panelDataBytes = 0;
+    }
+}
+
+void Hal_panelSelect(uint8_t selected) {
+    panelSelected = selected;
+}
+
+void Hal_panelWriteCommand(uint8_t cmd) {
+    ++halHostSpiBytes;
+    if(panelSelected) {
+        panelCommand = cmd;
+        panelDataBytes = 0;
+    }
+}
+
+void Hal_panelWriteData(uint8_t data) {
+    ++halHostSpiBytes;
+    if(!panelSelected || panelCommand != LCD_CMD_RAM_WRITE) {
+        return;
+    }
+
+    // Pixels are sent MSB first, the writes stop at the end of the window
+    uint32_t pixel = panelDataBytes >> 1;
+    if(pixel < LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT) {
+        if(panelDataBytes & 1) {
+            halHostPanel[pixel] |= data;
+            if(pixel == LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT - 1) {
+                ++halHostPanelFrames;
+                FrameCapture_frame(halHostPanel);
+            }
+        } else {
+            halHostPanel[pixel] = (uint16_t)data << 8;
+        }
+    }
+    ++panelDataBytes;
+}
+
+void Hal_simTimerInit() {
+    simTimerRunning = 1;
+}
+
+uint32_t Hal_simTimerNow() {
+    return aclk;
+}
+
+void Hal_adcInit() {
+}
+
+void Hal_adcStart() {
+    adcRunning = 1;
+    nextConversion = aclk + ACCELEROMETER_TRIGGER_PERIOD;
+}
+
+void Hal_adcStop() {
+    adcRunning = 0;
+}
+
+uint16_t Hal_adcSample(uint8_t slot) {
+    return adcRing[slot];
+}
+
+void Hal_hostAdcPush(uint16_t rawSample) {
+    adcRing[adcSlot] = rawSample;
+    adcSlot = (adcSlot + 1) % ACCELEROMETER_RING_SIZE;
+}
+
+void Hal_buttonInit() {
+}
+
+void Hal_buttonEnable() {
+    buttonEnabled = 1;
+    buttonPressed = 0;
+}
+
+void Hal_buttonDisable() {
+    ++games;
+    buttonEnabled = 0;
+}
+
+#ifdef UART_DEBUG
+void Hal_uartInit() {
+}
+#endif
+
+#endif
@@ -0,0 +1,328 @@
+/*
+ * halMsp432.c
+ *
+ *  Created on: Dec 4, 2016
+ *      Author: boer8364
+ */
+
+#include "globalMacros.h"
+
+#ifndef HOST_BUILD
+
+#include "hal.h"
+#include "simClock.h"
+#include "accelerometer.h"
+
+// Sets the LDO core voltage level, the PCM must not be busy when it is written
+static void setCoreVoltage(uint8_t level) {
+    while(PCM->CTL1 & PCM_CTL1_PMR_BUSY);
+    PCM->CTL0 = PCM_CTL0_KEY_VAL | (level ? PCM_CTL0_AMR_1 : PCM_CTL0_AMR_0);
+    while(PCM->CTL1 & PCM_CTL1_PMR_BUSY);
+}
+
+// Sets the read wait states and buffering of both flash banks
+static void setFlashWaitStates(uint8_t waitStates, uint8_t buffering) {
+    uint32_t buffers = buffering ?
+        FLCTL_BANK0_RDCTL_BUFD | FLCTL_BANK0_RDCTL_BUFI : 0;
+    FLCTL->BANK0_RDCTL = (FLCTL->BANK0_RDCTL & ~(FLCTL_BANK0_RDCTL_WAIT_MASK |
+        FLCTL_BANK0_RDCTL_BUFD | FLCTL_BANK0_RDCTL_BUFI)) |
+        ((uint32_t)waitStates << FLCTL_BANK0_RDCTL_WAIT_OFS) | buffers;
+    FLCTL->BANK1_RDCTL = (FLCTL->BANK1_RDCTL & ~(FLCTL_BANK1_RDCTL_WAIT_MASK |
+        FLCTL_BANK1_RDCTL_BUFD | FLCTL_BANK1_RDCTL_BUFI)) |
+        ((uint32_t)waitStates << FLCTL_BANK1_RDCTL_WAIT_OFS) | buffers;
+}
+
+void Hal_init() {
+    // Stop the watchdog timer
+    WDTCTL = WDTPW | WDTHOLD;
+
+    /* The clocks come out of reset at 3MHz, the lowest core voltage and no
+     * wait states, so this only ever raises them, the SPI and ADC are set up
+     * with the dividers of the profile later by their own init */
+    Hal_clockApply(&clockProfiles[clockProfile]);
+
+    // Time the rest of the boot
+    Hal_cycleCounterInit();
+}
+
+void Hal_clockApply(const ClockProfile_t* profile) {
+    uint8_t coreVoltage = (PCM->CTL0 & PCM_CTL0_CPM_MASK) >> PCM_CTL0_CPM_OFS;
+    uint8_t waitStates = (FLCTL->BANK0_RDCTL & FLCTL_BANK0_RDCTL_WAIT_MASK) >>
+        FLCTL_BANK0_RDCTL_WAIT_OFS;
+
+    // A faster clock needs the higher voltage and wait states first
+    if(profile->coreVoltage > coreVoltage) {
+        setCoreVoltage(profile->coreVoltage);
+    }
+    if(profile->flashWaitStates > waitStates) {
+        setFlashWaitStates(profile->flashWaitStates, profile->flashBuffering);
+    }
+
+    // Let the last byte of a frame go out at the old SPI clock
+    while(UCB0STATW & UCBUSY);
+
+    // Unlock the clock module
+    CS->KEY = CS_KEY_VAL;
+    // Set the DCO frequency range, with the tuning reset
+    CS->CTL0 = (uint32_t)profile->dcoRange << CS_CTL0_DCORSEL_OFS;
+    /* Configure clock sources:
+     * ACLK hooks up to REFOCLK (32.678kHz)
+     * SMCLK hooks up to DC0CLK, divided down by the profile
+     * HMCLKC hooks up to DC0CLKC */
+    CS->CTL1 = CS_CTL1_SELA_2 | CS_CTL1_SELS_3 | CS_CTL1_SELM_3 |
+        ((uint32_t)profile->smclkDividerLog2 << CS_CTL1_DIVS_OFS);
+    // Lock the clock module
+    CS->KEY = 0;
+
+    // The SPI bit clock divider can only change while the module is in reset
+    EUSCI_B0_SPI->CTLW0 |= EUSCI_B_CTLW0_SWRST;
+    EUSCI_B0_SPI->BRW = profile->spiDivider;
+    EUSCI_B0_SPI->CTLW0 &= ~EUSCI_B_CTLW0_SWRST;
+
+    // The ADC clock divider can only change while conversions are disabled
+    uint32_t adcEnabled = ADC14->CTL0 & ADC14_CTL0_ENC;
+    ADC14->CTL0 &= ~ADC14_CTL0_ENC;
+    ADC14->CTL0 = (ADC14->CTL0 & ~ADC14_CTL0_DIV_MASK) |
+        ((uint32_t)(profile->adcDivider - 1) << ADC14_CTL0_DIV_OFS);
+    ADC14->CTL0 |= adcEnabled;
+
+    // A slower clock can then do with less
+    if(profile->flashWaitStates < waitStates) {
+        setFlashWaitStates(profile->flashWaitStates, profile->flashBuffering);
+    }
+    if(profile->coreVoltage < coreVoltage) {
+        setCoreVoltage(profile->coreVoltage);
+    }
+}
+
+void Hal_waitForInterrupt(uint8_t deep) {
+    if(deep) {
+        /* Deep sleep enters LPM3, the PCM is left at its reset setting which
+         * selects LPM3 as the deep sleep mode */
+        SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+    } else {
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    }
+
+    /* With interrupts masked, a pending interrupt still wakes the CPU, but
+     * it is only serviced after the caller re-enables interrupts */
+    __WFI();
+
+    // Leave the deep sleep bit cleared so later sleeps default to LPM0
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+}
+
+void Hal_cycleCounterInit() {
+    // Enable the cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* Initialize the hardware for the LCD:
+ * SPI clock: P1.5
+ * SPI MOSI: P1.6
+ * Chip select: P5.0
+ * LCD reset pin: P5.7
+ * LCD DC pin (command/data select): P3.7 */
+void Hal_panelInit() {
+    // Configure primary configuration for P1.5 (SPI clock) and P1.6 (SPI MOSI)
+    P1SEL0 |= BIT5 | BIT6;
+    P1SEL1 &= ~(BIT5 | BIT6);
+
+    /* Configure directions for the reset, command/data select, and the chip
+     * select pin */
+    P3DIR |= BIT7;
+    P5DIR |= BIT0 | BIT7;
+
+    // SPI configuration
+    // Reset the SPI module
+    EUSCI_B0_SPI->CTLW0 |= EUSCI_B_CTLW0_SWRST;
+
+    /* Clock source will be SMCLK, divided down by the clock profile,
+     * MSB will be sent first,
+     * 3 pin mode will be used,
+     * 8 bit data will be used,
+     * Inactive state on the clock will be low (clock polarity) */
+    EUSCI_B0_SPI->CTLW0 |= EUSCI_B_CTLW0_CKPH | EUSCI_B_CTLW0_SSEL__SMCLK | EUSCI_B_CTLW0_MSB | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_MST;
+
+    // The bit clock divider of the current clock profile
+    EUSCI_B0_SPI->BRW = clockProfiles[clockProfile].spiDivider;
+
+    EUSCI_B0_SPI->CTLW0 &= ~EUSCI_B_CTLW0_SWRST;
+}
+
+void Hal_panelSetReset(uint8_t asserted) {
+    // The reset line is active low
+    if(asserted) {
+        P5OUT &= ~BIT7;
+    } else {
+        P5OUT |= BIT7;
+    }
+}
+
+void Hal_panelSelect(uint8_t selected) {
+    // The chip select line is active low
+    if(selected) {
+        P5OUT &= ~BIT0;
+    } else {
+        P5OUT |= BIT0;
+    }
+}
+
+void Hal_simTimerInit() {
+    /* Run the timer continuously off ACLK so that its count, together with
+     * the overflow count, forms the simulation timestamp */
+    TIMER_A2->CTL = TIMER_A_CTL_MC_2 | TIMER_A_CTL_SSEL__ACLK | TIMER_A_CTL_CLR;
+    // The first tick is one period away, the ISR schedules the next ones
+    TIMER_A2->CCR[0] = SIM_TICK_PERIOD;
+    // Interrupt on every tick and on every overflow
+    TIMER_A2->CCTL[0] = TIMER_A_CCTLN_CCIE;
+    TIMER_A2->CTL |= TIMER_A_CTL_IE;
+
+    NVIC_EnableIRQ(TA2_0_IRQn);
+    NVIC_EnableIRQ(TA2_N_IRQn);
+}
+
+uint32_t Hal_simTimerNow() {
+    uint16_t high;
+    uint16_t low;
+    uint16_t overflowPending;
+
+    /* Read the overflow count and the timer count until the overflow count
+     * does not change in between, so that a wrap-around is never missed */
+    do {
+        high = simClockOverflows;
+        low = TIMER_A2->R;
+        overflowPending = TIMER_A2->CTL & TIMER_A_CTL_IFG;
+    } while(high != simClockOverflows);
+
+    /* With interrupts disabled the overflow ISR can not run, so account for
+     * a wrap-around that has not been counted yet */
+    if(overflowPending && low < 0x8000) {
+        ++high;
+    }
+
+    return ((uint32_t)high << 16) | low;
+}
+
+void Hal_adcInit() {
+    //Configure pins to tertiary mode
+    //X-axis pins
+    P6SEL0 |= BIT1;
+    P6SEL1 |= BIT1;
+
+    //Y-axis pins
+    P4SEL0 |= BIT0;
+    P4SEL1 |= BIT0;
+
+    // Disable the ADC module so that it can be configured
+    ADC14->CTL0 &= ~ADC14_CTL0_ENC;
+
+    /* Configure the ADC:
+     * ADC14_CTL0_SSE__SMCLK: use SMCLK as the clock source
+     * ADC14_CTL0_SHT0_2: set the sample-and-hold time to 16 clock cycles
+     * ADC14_CTL0_SHP: set to pulse sampling mode
+     * ADC14_CTL0_SHS_7: start each conversion on TIMER_A3 CCR1
+     * ADC14_CTL0_CONSEQ_3: repeatedly step through the sequence of channels,
+     * one channel per trigger
+     * ADC14_CTL0_DIV: divide SMCLK by the divider of the clock profile */
+    ADC14->CTL0 = ADC14_CTL0_SSEL__SMCLK | ADC14_CTL0_SHT0_2 |
+        ADC14_CTL0_SHP | ADC14_CTL0_SHS_7 | ADC14_CTL0_CONSEQ_3 |
+        ((uint32_t)(clockProfiles[clockProfile].adcDivider - 1) <<
+        ADC14_CTL0_DIV_OFS);
+    // Set the ADC resolution to 14 bits
+    ADC14->CTL1 |= ADC14_CTL1_RES__14BIT;
+
+    /* No interrupts, the game loop reads the conversion memory directly
+     * whenever it needs a reading */
+    ADC14->IER0 = 0;
+
+    /* Alternate between the x channel (14) and the y channel (13) of the
+     * accelerometer across the conversion memory, which then holds the last
+     * few samples of each */
+    uint8_t i = 0;
+    for(; i < ACCELEROMETER_RING_SIZE; i += 2) {
+        ADC14->MCTL[i] = ADC14_MCTLN_INCH_14;
+        ADC14->MCTL[i + 1] = ADC14_MCTLN_INCH_13;
+    }
+    // Wrap back around to the start of the memory after the last slot
+    ADC14->MCTL[ACCELEROMETER_RING_SIZE - 1] |= ADC14_MCTLN_EOS;
+
+    // Turn on the ADC and enable conversion
+    ADC14->CTL0 |= ADC14_CTL0_ON | ADC14_CTL0_ENC;
+
+    /* Configure the conversion trigger, up mode on ACLK with a rising edge on
+     * the CCR1 output once per period, the timer is started and stopped by
+     * Hal_adcStart and Hal_adcStop */
+    TIMER_A3->CTL = TIMER_A_CTL_MC__STOP | TIMER_A_CTL_SSEL__ACLK |
+        TIMER_A_CTL_CLR;
+    TIMER_A3->CCR[0] = ACCELEROMETER_TRIGGER_PERIOD - 1;
+    TIMER_A3->CCR[1] = ACCELEROMETER_TRIGGER_PERIOD / 2;
+    TIMER_A3->CCTL[1] = TIMER_A_CCTLN_OUTMOD_7;
+}
+
+void Hal_adcStart() {
+    // Clear the count so the first trigger is a full period away
+    TIMER_A3->CTL |= TIMER_A_CTL_CLR;
+    TIMER_A3->CTL |= TIMER_A_CTL_MC__UP;
+}
+
+void Hal_adcStop() {
+    // Stopping the triggers stops the conversions
+    TIMER_A3->CTL &= ~TIMER_A_CTL_MC_3;
+}
+
+void Hal_buttonInit() {
+    // Set the pin as an input
+    P3DIR &= ~BIT5;
+    // Enable a resistor
+    P3REN |= BIT5;
+    // Set the resistor to be pull-up
+    P3OUT |= BIT5;
+
+    // Enable interrupts from port 3
+    NVIC_EnableIRQ(PORT3_IRQn);
+}
+
+void Hal_buttonEnable() {
+    // Clear the interrupt flags
+    P3IFG = 0x00;
+    // Select the negative edge
+    P3IES |= BIT5;
+    // Enable the interrupt
+    P3IE |= BIT5;
+    // Reset the global button press flag
+    buttonPressed = 0;
+}
+
+void Hal_buttonDisable() {
+    // Clear the interrupt enable flag
+    P3IE &= ~BIT5;
+}
+
+#ifdef UART_DEBUG
+void Hal_uartInit() {
+    // Change the TX and RX pins to their primary mode
+    P1SEL0 |= BIT2 | BIT3;
+    P1SEL1 &= ~(BIT2 | BIT3);
+
+    // Reset the eUSCI module
+    EUSCI_A0->CTLW0 |= UCSWRST;
+
+    // Use ACLK as the clock source
+    EUSCI_A0->CTLW0 |= UCSSEL__ACLK;
+    // Divide it by 3 to get a 9600 baud rate
+    EUSCI_A0->BRW = 3;
+    // Set the modulation so that we get a 9600 baud rate
+    EUSCI_A0->MCTLW = 0x92 << 8;
+
+    // Enable the eUSCI module
+    EUSCI_A0->CTLW0 &= ~UCSWRST;
+
+    /* Enable the TX interrupt in the NVIC, the logger turns the interrupt on
+     * in the module whenever it has bytes to send */
+    NVIC_EnableIRQ(EUSCIA0_IRQn);
+}
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * input.c
+ *
+ *  Created on: Dec 15, 2016
+ *      Author: boer8364
+ */
+
+#include "input.h"
+
+#include "player.h"
+
+/* Gain of the mapping without a curve, PLAYER_SPEED / 3095.96 (the exact full
+ * tilt magnitude) in fixed point, applying it drops LINEAR_GAIN_SHIFT bits to
+ * leave the velocity's fraction bits */
+#define LINEAR_GAIN_FRACTION_BITS 24
+#define LINEAR_GAIN_SHIFT \
+    (LINEAR_GAIN_FRACTION_BITS - INPUT_VELOCITY_FRACTION_BITS)
+#define LINEAR_GAIN ((int32_t)(((int64_t)PLAYER_SPEED * \
+    (1LL << LINEAR_GAIN_FRACTION_BITS) * 100 + 309596 / 2) / 309596))
+
+const uint16_t INPUT_CURVE_LINEAR[INPUT_CURVE_SEGMENTS + 1] = {
+    0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048,
+    2304, 2560, 2816, 3072, 3328, 3584, 3840, 4096
+};
+
+const uint16_t INPUT_CURVE_QUADRATIC[INPUT_CURVE_SEGMENTS + 1] = {
+    0, 16, 64, 144, 256, 400, 576, 784, 1024,
+    1296, 1600, 1936, 2304, 2704, 3136, 3600, 4096
+};
+
+// Integer square root, rounded down
+static uint32_t squareRoot(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    // Start at the highest power of four that fits
+    while(bit > value) {
+        bit >>= 2;
+    }
+
+    // Work out one bit of the root at a time
+    while(bit) {
+        if(value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+// Divides, rounding to the nearest integer, the divisor must be positive
+static int32_t divideRounded(int32_t dividend, int32_t divisor) {
+    if(dividend < 0) {
+        return -((-dividend + divisor / 2) / divisor);
+    }
+    return (dividend + divisor / 2) / divisor;
+}
+
+void Input_map(const InputConfig_t* config,
+    const AccelerometerReading_t* reading, InputVelocity_t* velocity) {
+    // The accelerometer y axis points up the screen, the screen's points down
+    int32_t x = reading->x;
+    int32_t y = -reading->y;
+
+    if(!config->curve && !config->deadZone) {
+        /* The velocity is just the tilt scaled down, so there is no need for
+         * the magnitude */
+        velocity->x = (int16_t)((x * LINEAR_GAIN +
+            (1L << (LINEAR_GAIN_SHIFT - 1))) >> LINEAR_GAIN_SHIFT);
+        velocity->y = (int16_t)((y * LINEAR_GAIN +
+            (1L << (LINEAR_GAIN_SHIFT - 1))) >> LINEAR_GAIN_SHIFT);
+        return;
+    }
+
+    // The readings are 14-bit, so the squares can not overflow
+    int32_t magnitude = (int32_t)squareRoot((uint32_t)(x * x + y * y));
+    if(magnitude <= config->deadZone) {
+        velocity->x = 0;
+        velocity->y = 0;
+        return;
+    }
+
+    // Find the speed, in fixed point pixels, for this tilt
+    int32_t speed;
+    if(config->curve) {
+        /* Position along the curve with 8 fraction bits, clamped at a full
+         * tilt */
+        int32_t span = INPUT_MAX_MAGNITUDE - config->deadZone;
+        int32_t position = ((magnitude - config->deadZone) *
+            (INPUT_CURVE_SEGMENTS << 8)) / span;
+        if(position > (INPUT_CURVE_SEGMENTS << 8)) {
+            position = INPUT_CURVE_SEGMENTS << 8;
+        }
+        int32_t segment = position >> 8;
+        int32_t fraction = position & 0xff;
+        int32_t curveValue = config->curve[segment];
+        if(fraction) {
+            curveValue += ((config->curve[segment + 1] - curveValue) *
+                fraction) >> 8;
+        }
+        speed = (curveValue * (PLAYER_SPEED << INPUT_VELOCITY_FRACTION_BITS) +
+            (1L << (INPUT_CURVE_FRACTION_BITS - 1))) >>
+            INPUT_CURVE_FRACTION_BITS;
+    } else {
+        // No curve, a straight line starting at the edge of the dead zone
+        speed = ((magnitude - config->deadZone) * LINEAR_GAIN +
+            (1L << (LINEAR_GAIN_SHIFT - 1))) >> LINEAR_GAIN_SHIFT;
+    }
+
+    // Point the speed along the tilt
+    velocity->x = (int16_t)divideRounded(x * speed, magnitude);
+    velocity->y = (int16_t)divideRounded(y * speed, magnitude);
+}
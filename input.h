@@ -0,0 +1,56 @@
+/*
+ * input.h
+ *
+ *  Created on: Dec 15, 2016
+ *      Author: boer8364
+ */
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "accelerometer.h"
+
+/* Velocities are in fixed point pixels per simulation tick, with
+ * INPUT_VELOCITY_FRACTION_BITS of sub-pixel precision */
+#define INPUT_VELOCITY_FRACTION_BITS 8
+// Converts a fixed point velocity component to pixels
+#define INPUT_VELOCITY_TO_DOUBLE(v) \
+    ((double)(v) / (double)(1 << INPUT_VELOCITY_FRACTION_BITS))
+
+// Magnitude of the x and y readings at a full tilt (found in datasheet)
+#define INPUT_MAX_MAGNITUDE 3096
+/* Response curves map the tilt, from the edge of the dead zone up to a full
+ * tilt, to a fraction of PLAYER_SPEED, they are sampled at
+ * INPUT_CURVE_SEGMENTS + 1 evenly spaced points and linearly interpolated in
+ * between */
+#define INPUT_CURVE_SEGMENTS 16
+// Curve values are fractions of PLAYER_SPEED with this many fraction bits
+#define INPUT_CURVE_FRACTION_BITS 12
+
+// Straight line, the same response as without a curve but with a dead zone
+extern const uint16_t INPUT_CURVE_LINEAR[INPUT_CURVE_SEGMENTS + 1];
+// Squared tilt, gives finer control near level
+extern const uint16_t INPUT_CURVE_QUADRATIC[INPUT_CURVE_SEGMENTS + 1];
+
+// Input mapping settings
+typedef struct InputConfig {
+    // Tilts up to this magnitude, in ADC counts, do not move the player
+    uint16_t deadZone;
+    /* Response curve, NULL maps the tilt straight to the velocity without
+     * clamping it at a full tilt (the original mapping) */
+    const uint16_t* curve;
+} InputConfig_t;
+
+// Velocity in screen coordinates, in fixed point
+typedef struct InputVelocity {
+    int16_t x;
+    int16_t y;
+} InputVelocity_t;
+
+// Maps an accelerometer reading to a player velocity, using integers only
+void Input_map(const InputConfig_t* config,
+    const AccelerometerReading_t* reading, InputVelocity_t* velocity);
+
+#endif /* INPUT_H_ */
@@ -0,0 +1,344 @@
+/*
+ * lcdBenchmark.c
+ *
+ *  Created on: Dec 21, 2016
+ *      Author: boer8364
+ */
+
+#include "lcdBenchmark.h"
+#include "lcdDriver.h"
+#include "hal.h"
+#include "bitmaps.h"
+#include "wall.h"
+#include "wallBuffer.h"
+#include "player.h"
+
+#ifdef HOST_BUILD
+#include <stdio.h>
+
+#define PUT_STRING(str) fputs(str, stdout)
+#define PUT_NUMBER(num) printf("%ld", (long)(num))
+#define LINE_END "\n"
+#elif defined(UART_DEBUG)
+#include "uartLogger.h"
+
+#define PUT_STRING(str) UART_Logger_sendString(str)
+#define PUT_NUMBER(num) UART_Logger_sendNumSigned((int32_t)(num))
+#define LINE_END "\r"
+#else
+// No output, the results are left in lcdBenchmarkResults
+#define PUT_STRING(str) ((void)(str))
+#define PUT_NUMBER(num) ((void)(num))
+#define LINE_END ""
+#endif
+
+// Most parameters a case sweeps over
+#define LCD_BENCHMARK_MAX_PARAMS 9
+
+// Radius step between the walls of a scene, the innermost clears the player
+#define SCENE_WALL_STEP \
+    ((WALL_INITIAL_RADIUS - PLAYER_RADIUS - 2) / WALL_BUFFER_SIZE)
+
+typedef struct LcdBenchmarkCase {
+    const char* name;
+    // Draws the primitive once with the given parameter
+    void (*run)(int16_t param);
+    int16_t params[LCD_BENCHMARK_MAX_PARAMS];
+    uint8_t numParams;
+} LcdBenchmarkCase_t;
+
+LcdBenchmarkResult_t lcdBenchmarkResults[LCD_BENCHMARK_MAX_RESULTS]
+    MEMORY_SECTION(".debugbuffers");
+uint8_t lcdBenchmarkNumResults = 0;
+
+// Walls of the scene cases, outermost first, and the player
+static Wall_t sceneWalls[WALL_BUFFER_SIZE];
+static Wall_t sceneBoundary;
+static Player_t scenePlayer;
+
+/* ***** Cases ***** */
+
+static void runClear(int16_t param) {
+    (void)param;
+    LCD_clearBuffer();
+}
+
+// A square of param by param pixels
+static void runFillRect(int16_t param) {
+    LCD_fillRect(0, 0, param - 1, param - 1);
+}
+
+// A 45 degree line param pixels long on each axis
+static void runLineDiagonal(int16_t param) {
+    LCD_drawLine(0, 0, param - 1, param - 1);
+}
+
+// A line across the screen that rises param pixels
+static void runLineShallow(int16_t param) {
+    LCD_drawLine(0, 0, LCD_SCREEN_WIDTH - 1, param);
+}
+
+static void runLineVertical(int16_t param) {
+    LCD_drawLineVertical(0, 0, param - 1);
+}
+
+static void runLineHorizontal(int16_t param) {
+    LCD_drawLineHorizontal(0, param - 1, 0);
+}
+
+static void runCircle(int16_t param) {
+    LCD_drawCircle(WALL_CENTER_X, WALL_CENTER_Y, param);
+}
+
+static void runFillCircle(int16_t param) {
+    LCD_fillCircle(WALL_CENTER_X, WALL_CENTER_Y, param);
+}
+
+// A gap long arc, starting on the positive x axis, of radius param
+static void runArcRadius(int16_t param) {
+    LCD_drawArc(WALL_CENTER_X, WALL_CENTER_Y, param, 0.0,
+        WALL_GAP_ANGULAR_LENGTH);
+}
+
+// A gap long arc on the boundary, starting param degrees around
+static void runArcAngle(int16_t param) {
+    double startAngle = param * (CONSTANT_PI / 180.0);
+    LCD_drawArc(WALL_CENTER_X, WALL_CENTER_Y, WALL_INITIAL_RADIUS,
+        startAngle, startAngle + WALL_GAP_ANGULAR_LENGTH);
+}
+
+// The boundary, the param outermost scene walls and the player
+static void runScene(int16_t param) {
+    Wall_draw(&sceneBoundary);
+    int16_t i = 0;
+    for(; i < param; ++i) {
+        Wall_draw(&sceneWalls[i]);
+    }
+    Player_draw(&scenePlayer);
+}
+
+static void runSend(int16_t param) {
+    (void)param;
+    LCD_sendBuffer();
+}
+
+static void runSendAndClear(int16_t param) {
+    (void)param;
+    LCD_sendAndClearBuffer();
+}
+
+static void runSendCustom(int16_t param) {
+    (void)param;
+    LCD_sendCustomBuffer(START_SCREEN_BITMAP);
+}
+
+// A whole game frame, a scene of param walls sent to the panel
+static void runFrame(int16_t param) {
+    runScene(param);
+    LCD_sendAndClearBuffer();
+}
+
+static const LcdBenchmarkCase_t CASES[] = {
+    {"clear", runClear, {0}, 1},
+    {"fill rect", runFillRect, {1, 8, 32, 64, 128}, 5},
+    {"line diagonal", runLineDiagonal, {8, 32, 128}, 3},
+    {"line shallow", runLineShallow, {1, 16, 64}, 3},
+    {"line vertical", runLineVertical, {8, 32, 128}, 3},
+    {"line horizontal", runLineHorizontal, {8, 32, 128}, 3},
+    {"circle", runCircle, {4, 16, 32, 63}, 4},
+    {"fill circle", runFillCircle, {3, 16, 32, 63}, 4},
+    {"arc radius", runArcRadius, {4, 16, 32, 63}, 4},
+    {"arc angle", runArcAngle, {-180, -135, -90, -45, -18, 0, 45, 90, 135},
+        9},
+    {"scene walls", runScene, {0, 1, 4, 8, WALL_BUFFER_SIZE}, 5},
+    {"send", runSend, {0}, 1},
+    {"send and clear", runSendAndClear, {0}, 1},
+    {"send custom", runSendCustom, {0}, 1},
+    {"frame", runFrame, {WALL_BUFFER_SIZE}, 1}
+};
+
+#define NUM_CASES (sizeof(CASES) / sizeof(CASES[0]))
+
+/* ***** Harness ***** */
+
+/* Builds the scene walls, evenly spaced from the boundary in to the player,
+ * with their gaps spread around the circle so the arcs cross every quadrant */
+static void buildScene() {
+    Wall_init(&sceneBoundary, 0.0, 0.0);
+    sceneBoundary.radius = WALL_INITIAL_RADIUS;
+
+    uint8_t i = 0;
+    for(; i < WALL_BUFFER_SIZE; ++i) {
+        WallAngle_t gapStart = WALL_SECTOR_TO_ANGLE(
+            (i * 7) % WALL_ANGLE_GENERATION_RESOLUTION);
+        WallAngle_t gapEnd = (WallAngle_t)(gapStart + WALL_GAP_BINARY_LENGTH);
+        Wall_init(&sceneWalls[i], WALL_ANGLE_TO_RADIANS(gapStart),
+            WALL_ANGLE_TO_RADIANS(gapEnd));
+
+        // The second gap is on the opposite side
+        gapStart = (WallAngle_t)(gapStart + 32768);
+        gapEnd = (WallAngle_t)(gapStart + WALL_GAP_BINARY_LENGTH);
+        Wall_addGap(&sceneWalls[i], WALL_ANGLE_TO_RADIANS(gapStart),
+            WALL_ANGLE_TO_RADIANS(gapEnd));
+
+        sceneWalls[i].radius = WALL_INITIAL_RADIUS - 1 - i * SCENE_WALL_STEP;
+    }
+
+    Vector2d_t center = {WALL_CENTER_X, WALL_CENTER_Y};
+    Player_init(&scenePlayer, &center);
+}
+
+// Smallest time two back to back counter reads can measure
+static uint32_t measureOverhead() {
+    uint32_t overhead = UINT32_MAX;
+    uint16_t i = 0;
+    for(; i < LCD_BENCHMARK_ITERATIONS; ++i) {
+        uint32_t start = Hal_cycleCount();
+        uint32_t ticks = Hal_cycleCount() - start;
+        if(ticks < overhead) {
+            overhead = ticks;
+        }
+    }
+    return overhead;
+}
+
+static void measure(const LcdBenchmarkCase_t* benchmarkCase, int16_t param,
+    uint32_t overhead, LcdBenchmarkResult_t* result) {
+    result->name = benchmarkCase->name;
+    result->param = param;
+    result->min = UINT32_MAX;
+    result->max = 0;
+
+    uint64_t total = 0;
+    uint16_t i = 0;
+    for(; i < LCD_BENCHMARK_ITERATIONS; ++i) {
+        uint32_t start = Hal_cycleCount();
+        benchmarkCase->run(param);
+        uint32_t ticks = Hal_cycleCount() - start;
+        ticks = ticks > overhead ? ticks - overhead : 0;
+
+        total += ticks;
+        if(ticks < result->min) {
+            result->min = ticks;
+        }
+        if(ticks > result->max) {
+            result->max = ticks;
+        }
+    }
+    result->average = (uint32_t)(total / LCD_BENCHMARK_ITERATIONS);
+
+    // Start every case from an empty buffer, this is not timed
+    LCD_clearBuffer();
+}
+
+/* Waits for the UART to send what has been logged so far, a whole report
+ * does not fit in the logger buffer */
+static void flush() {
+#if !defined(HOST_BUILD) && defined(UART_DEBUG)
+    UART_Logger_flush();
+#endif
+}
+
+/* Where the RAMFUNC primitives ran from, benchmarks of a build with and one
+ * without RAMFUNC_DISABLE are compared with tools/benchCompare.c */
+#if defined(HOST_BUILD)
+#define CODE_PLACEMENT "host"
+#elif defined(RAMFUNC_DISABLE)
+#define CODE_PLACEMENT "flash"
+#else
+#define CODE_PLACEMENT "sram"
+#endif
+
+static void printResult(LcdBenchmarkFormat_t format,
+    const LcdBenchmarkResult_t* result, uint8_t first) {
+    if(format == LCD_BENCHMARK_JSON) {
+        PUT_STRING(first ? "  {\"primitive\": \"" :
+            "," LINE_END "  {\"primitive\": \"");
+        PUT_STRING(result->name);
+        PUT_STRING("\", \"param\": ");
+        PUT_NUMBER(result->param);
+        PUT_STRING(", \"iterations\": ");
+        PUT_NUMBER(LCD_BENCHMARK_ITERATIONS);
+        PUT_STRING(", \"min\": ");
+        PUT_NUMBER(result->min);
+        PUT_STRING(", \"avg\": ");
+        PUT_NUMBER(result->average);
+        PUT_STRING(", \"max\": ");
+        PUT_NUMBER(result->max);
+        PUT_STRING(", \"code\": \"" CODE_PLACEMENT "\"}");
+    } else {
+        PUT_STRING(result->name);
+        PUT_STRING(",");
+        PUT_NUMBER(result->param);
+        PUT_STRING(",");
+        PUT_NUMBER(LCD_BENCHMARK_ITERATIONS);
+        PUT_STRING(",");
+        PUT_NUMBER(result->min);
+        PUT_STRING(",");
+        PUT_NUMBER(result->average);
+        PUT_STRING(",");
+        PUT_NUMBER(result->max);
+        PUT_STRING("," CODE_PLACEMENT LINE_END);
+    }
+    flush();
+}
+
+void LcdBenchmark_run(LcdBenchmarkFormat_t format) {
+#ifdef HOST_BUILD
+    const char* unit = "ns";
+#else
+    const char* unit = "cycles";
+#endif
+    // The cases change the colors, the caller gets its own back
+    uint16_t savedForeground = foregroundColor;
+    uint16_t savedBackground = backgroundColor;
+
+    Hal_cycleCounterInit();
+    buildScene();
+    LCD_setBackgroundColor(WALL_GAP_COLOR);
+    LCD_setForegroundColor(WALL_WALL_COLOR);
+    LCD_clearBuffer();
+    uint32_t overhead = measureOverhead();
+
+    if(format == LCD_BENCHMARK_JSON) {
+        PUT_STRING("{\"unit\": \"");
+        PUT_STRING(unit);
+        PUT_STRING("\", \"overhead\": ");
+        PUT_NUMBER(overhead);
+        PUT_STRING(", \"results\": [" LINE_END);
+    } else {
+        PUT_STRING("primitive,param,iterations,min_");
+        PUT_STRING(unit);
+        PUT_STRING(",avg_");
+        PUT_STRING(unit);
+        PUT_STRING(",max_");
+        PUT_STRING(unit);
+        PUT_STRING(",code" LINE_END);
+    }
+    flush();
+
+    lcdBenchmarkNumResults = 0;
+    uint8_t i = 0;
+    for(; i < NUM_CASES; ++i) {
+        uint8_t j = 0;
+        for(; j < CASES[i].numParams &&
+            lcdBenchmarkNumResults < LCD_BENCHMARK_MAX_RESULTS; ++j) {
+            // The walls and the player pick their own colors
+            LCD_setForegroundColor(WALL_WALL_COLOR);
+            LcdBenchmarkResult_t* result =
+                &lcdBenchmarkResults[lcdBenchmarkNumResults];
+            measure(&CASES[i], CASES[i].params[j], overhead, result);
+            printResult(format, result, lcdBenchmarkNumResults == 0);
+            ++lcdBenchmarkNumResults;
+        }
+    }
+
+    if(format == LCD_BENCHMARK_JSON) {
+        PUT_STRING(LINE_END "]}" LINE_END);
+        flush();
+    }
+
+    LCD_setForegroundColor(savedForeground);
+    LCD_setBackgroundColor(savedBackground);
+    LCD_clearBuffer();
+}
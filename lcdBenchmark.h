@@ -0,0 +1,62 @@
+/*
+ * lcdBenchmark.h
+ *
+ *  Created on: Dec 21, 2016
+ *      Author: boer8364
+ */
+
+#ifndef LCDBENCHMARK_H_
+#define LCDBENCHMARK_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+/* Microbenchmarks of the lcdDriver primitives. Every case draws one primitive
+ * over a sweep of one parameter (a size, a radius or an angle) and times each
+ * call with Hal_cycleCount, so the results are MCLK cycles on the target and
+ * nanoseconds on the host, with the cost of reading the counter taken out.
+ * The scene cases draw the boundary, up to WALL_BUFFER_SIZE concentric walls
+ * with two gaps each and the player, which is the worst frame the game can
+ * produce. On the target the interrupts stay enabled, so the minimum is the
+ * number to compare and the maximum shows what the ISRs add */
+
+// Output format of the results
+typedef enum LcdBenchmarkFormat {
+    // One row per case and parameter, with a header row
+    LCD_BENCHMARK_CSV = 0,
+    // A single object holding the unit and an array of the rows
+    LCD_BENCHMARK_JSON
+} LcdBenchmarkFormat_t;
+
+// Timed calls per case and parameter
+#ifdef HOST_BUILD
+#define LCD_BENCHMARK_ITERATIONS 1000
+#else
+#define LCD_BENCHMARK_ITERATIONS 16
+#endif
+
+// Room for the results of every case and parameter
+#define LCD_BENCHMARK_MAX_RESULTS 64
+
+typedef struct LcdBenchmarkResult {
+    // Name of the case
+    const char* name;
+    // Parameter the case was run with
+    int16_t param;
+    // Time of a single call, in Hal_cycleCount units
+    uint32_t min;
+    uint32_t average;
+    uint32_t max;
+} LcdBenchmarkResult_t;
+
+/* Results of the last run, for the debugger to read out when the target has
+ * no UART to print them on */
+extern LcdBenchmarkResult_t lcdBenchmarkResults[LCD_BENCHMARK_MAX_RESULTS];
+extern uint8_t lcdBenchmarkNumResults;
+
+/* Runs every case and prints the results, on stdout on the host and over the
+ * UART with UART_DEBUG on the target. LCD_init must have been called, the
+ * panel is written to by the send cases and the buffer is left cleared */
+void LcdBenchmark_run(LcdBenchmarkFormat_t format);
+
+#endif /* LCDBENCHMARK_H_ */
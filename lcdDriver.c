@@ -7,167 +7,165 @@
 #include "lcdDriver.h"
 
 #include <math.h>
-#include "msp.h"
-
-uint16_t pixelBuffer[LCD_SCREEN_HEIGHT * LCD_SCREEN_WIDTH];
+#include <stdlib.h>
+#include "globalMacros.h"
+#include "hal.h"
+#include "profiler.h"
+#include "counters.h"
+#include "overdraw.h"
+
+uint16_t pixelBuffer[LCD_SCREEN_HEIGHT * LCD_SCREEN_WIDTH]
+    MEMORY_SECTION(".framebuffer") MEMORY_ALIGN(LCD_FRAMEBUFFER_ALIGNMENT);
 /* Array of pointers that will be used to point to the starts of rows in the
  * pixelBuffer, this will allow us to address pixel data in the same way one
  * would address elements of a matrix */
-uint16_t* pixelBufferOverlay[LCD_SCREEN_HEIGHT];
+uint16_t* pixelBufferOverlay[LCD_SCREEN_HEIGHT]
+    MEMORY_SECTION(".framebuffer");
 
 // Foreground and background colors
 uint16_t foregroundColor = 0x0000;
 uint16_t backgroundColor = 0xffff;
 
-inline void LCD_sendByte(uint8_t bytePacket) {
-    // Block until the SPI transmitter is ready
-    while(UCB0STATW & UCBUSY);
-    // Send the packet
-    UCB0TXBUF = bytePacket;
-}
+/* Writes the foreground color to a pixel, every primitive draws through this
+ * so that the debug counters and the overdraw map see each write */
+#define WRITE_PIXEL(primitive, x, y) do { \
+        pixelBufferOverlay[(y)][(x)] = foregroundColor; \
+        COUNT_PIXELS((primitive), 1); \
+        COUNT_OVERDRAW((x), (y)); \
+    } while(0)
 
 void LCD_writeCommand(uint8_t cmd) {
-    // Turn on command mode for the LCD
-    P3OUT &= ~BIT7;
-    // Send the desired command
-    LCD_sendByte(cmd);
-    // Turn off command mode for the LCD
-    P3OUT |= BIT7;
+    COUNT_WORK(spiBytes, 1);
+    Hal_panelWriteCommand(cmd);
 }
 
-void LCD_writeData(uint8_t data) {
-    // Simply send the data
-    LCD_sendByte(data);
+// Runs from SRAM, it is called for every byte of a frame
+RAMFUNC void LCD_writeData(uint8_t data) {
+    COUNT_WORK(spiBytes, 1);
+    Hal_panelWriteData(data);
 }
 
-/* Initialize the hardware for the LCD:
- * SPI clock: P1.5
- * SPI MOSI: P1.6
- * Chip select: P5.0
- * LCD reset pin: P5.7
- * LCD DC pin (command/data select): P3.7 */
-void LCD_init() {
-    // Configure primary configuration for P1.5 (SPI clock) and P1.6 (SPI MOSI)
-    P1SEL0 |= BIT5 | BIT6;
-    P1SEL1 &= ~(BIT5 | BIT6);
-
-    /* Configure directions for the reset, command/data select, and the chip
-     * select pin */
-    P3DIR |= BIT7;
-    P5DIR |= BIT0 | BIT7;
-
-    // Clock configuration
-    // Unlock the clock module
-    CS->KEY = 0x695a;
-    // Reset the clock configuration
-    CS->CTL0 = 0;
-    // Set DC0 to run at 24MHz
-    CS->CTL0 = 0x04 << 16;
-    /* Configure clock sources:
-     * ACLK hooks up to REFOCLK (32.678kHz)
-     * SMCLK hooks up to DC0CLK
-     * HMCLKC hooks up to DC0CLKC */
-    CS->CTL1 = CS_CTL1_SELA_2 | CS_CTL1_SELS_3 | CS_CTL1_SELM_3;
-    // Lock the clock module
-    CS->KEY = 0;
-
-    // SPI configuration
-    // Reset the SPI module
-    EUSCI_B0_SPI->CTLW0 |= EUSCI_B_CTLW0_SWRST;
-
-    // The SPI needs a 16MHz clock (experiment with this later)
-    /* Clock source will be SMCLK (running at 48MHz and divided down to 16Mhz),
-     * MSB will be sent first,
-     * 3 pin mode will be used,
-     * 8 bit data will be used,
-     * Inactive state on the clock will be low (clock polarity) */
-    EUSCI_B0_SPI->CTLW0 |= EUSCI_B_CTLW0_CKPH | EUSCI_B_CTLW0_SSEL__SMCLK | EUSCI_B_CTLW0_MSB | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_MST;
-
-    // 48MHz / 16Mhz = 3
-    EUSCI_B0_SPI->BRW = 1;
-
-    EUSCI_B0_SPI->CTLW0 &= ~EUSCI_B_CTLW0_SWRST;
+/* Flag in the data byte count of an init sequence entry, the entry ends with
+ * a delay in microseconds */
+#define INIT_DELAY 0x80
 
-    // Reset the LCD
-    P5OUT &= ~BIT7;
-    LCD_DELAY(50);
-    P5OUT |= BIT7;
-    LCD_DELAY(120);
+/* Set up sequence of the panel after it woke up, each entry is the command,
+ * the number of data bytes, the data bytes and the delay if flagged */
+static const uint8_t INIT_SEQUENCE[] = {
+    // Set the gamma value
+    LCD_CMD_SET_GAMMA, 1, 0x04,
+    // Set the frame rate (needs more investigation)
+    LCD_CMD_FRAME_RATE_CONTROL, 2, 0x0a, 0x14,
+    // Set the power mode
+    LCD_CMD_POWER_CONTROL, 2, 0x0a, 0x00,
+    // Set the pixel format to 16 bit mode
+    LCD_CMD_PIXEL_FORMAT_CONTROL, 1 | INIT_DELAY, 0x05, 10,
+    // Set the pixel data write order
+    LCD_CMD_DATA_ACCESS_CONTROL, 1, 0xc8,
+    // Set the display mode to normal
+    LCD_CMD_NORMAL_DISPLAY_MODE, 0,
+    // Set the column (x) window, lower and upper bound
+    LCD_CMD_COLUMN_ADDRESS_SELECT, 4, 0x02 >> 8, 0x02, 0x81 >> 8, 0x81,
+    // Set the row (y) window, lower and upper bound
+    LCD_CMD_ROW_ADDRESS_SELECT, 4, 0x03 >> 8, 0x03, 0x82 >> 8, 0x82
+};
+
+/* Panel timings in microseconds, the values LCD_DELAY used at 48MHz: the
+ * reset pulse, the recovery after it */
+#define RESET_PULSE_DELAY 50
+#define RESET_DELAY 120
+// and the wake up time after the sleep out command
+#define WAKE_UP_DELAY 200
+
+/* Cycle count a panel delay lasts at the MCLK of the current profile, the
+ * host panel model is ready at once */
+#ifdef HOST_BUILD
+#define PANEL_DELAY_CYCLES(us) ((void)(us), 0)
+#else
+#define PANEL_DELAY_CYCLES(us) HAL_US_TO_CYCLES(us)
+#endif
 
-    P5OUT &= ~BIT0;
+// Cycle count at which the panel has recovered from the reset
+static uint32_t panelResetTime;
 
-    // Run some commands
-    // Turn off sleep mode
-    LCD_writeCommand(LCD_CMD_SLEEP_OUT);
-    LCD_DELAY(200);
+/* Busy-waits until the cycle count reaches a deadline, for the delays that are
+ * not known at compile time, returns the cycles waited */
+static uint32_t waitUntil(uint32_t deadline) {
+    uint32_t start = Hal_cycleCount();
+    while((int32_t)(Hal_cycleCount() - deadline) < 0);
+    return (int32_t)(deadline - start) > 0 ? deadline - start : 0;
+}
 
-    // Set the gamma value
-    LCD_writeCommand(LCD_CMD_SET_GAMMA);
-    LCD_writeData(0x04);
+void LCD_initStart() {
+    // Set up the SPI bus and the control lines of the panel
+    Hal_panelInit();
 
-    // Set the frame rate (needs more investigation)
-    LCD_writeCommand(LCD_CMD_FRAME_RATE_CONTROL);
-    LCD_writeData(0x0a);
-    LCD_writeData(0x14);
+    // Reset the LCD
+    Hal_panelSetReset(1);
+    uint32_t deadline = Hal_cycleCount() +
+        PANEL_DELAY_CYCLES(RESET_PULSE_DELAY);
+    /* Setup the pixelBufferOverlay so that its pointers point to the start of
+     * each row on the screen, while the reset is held */
+    unsigned int i = 0;
+    for(; i < LCD_SCREEN_HEIGHT; ++i) {
+        pixelBufferOverlay[i] = &pixelBuffer[i * LCD_SCREEN_WIDTH];
+    }
+    waitUntil(deadline);
+    Hal_panelSetReset(0);
 
-    // Set the power mode
-    LCD_writeCommand(LCD_CMD_POWER_CONTROL);
-    LCD_writeData(0x0a);
-    LCD_writeData(0x00);
+    // LCD_initFinish waits for the recovery before waking the panel up
+    panelResetTime = Hal_cycleCount() + PANEL_DELAY_CYCLES(RESET_DELAY);
+}
 
-    // Set the pixel format to 16 bit mode
-    LCD_writeCommand(LCD_CMD_PIXEL_FORMAT_CONTROL);
-    LCD_writeData(0x05);
-    LCD_DELAY(10);
+uint32_t LCD_initFinish() {
+    uint32_t waited = waitUntil(panelResetTime);
 
-    // Set the pixel data write order
-    LCD_writeCommand(LCD_CMD_DATA_ACCESS_CONTROL);
-    LCD_writeData(0xc8);
+    Hal_panelSelect(1);
 
-    // Set the display mode to normal
-    LCD_writeCommand(LCD_CMD_NORMAL_DISPLAY_MODE);
-
-    // Set the column (x) window
-    LCD_writeCommand(LCD_CMD_COLUMN_ADDRESS_SELECT);
-    // Lower x bound
-    LCD_writeData(0x02 >> 8);
-    LCD_writeData(0x02);
-    // Upper x bound
-    LCD_writeData(0x81 >> 8);
-    LCD_writeData(0x81);
-
-    // Set the row (y) window
-    LCD_writeCommand(LCD_CMD_ROW_ADDRESS_SELECT);
-    // Lower y bound
-    LCD_writeData(0x03 >> 8);
-    LCD_writeData(0x03);
-    // Upper y bound
-    LCD_writeData(0x82 >> 8);
-    LCD_writeData(0x82);
-
-    // Start with a white screen
-    // Initiate a display write
-    LCD_writeCommand(LCD_CMD_RAM_WRITE);
-    // Write every pixel to be white
+    // Turn off sleep mode
+    LCD_writeCommand(LCD_CMD_SLEEP_OUT);
+    uint32_t panelAwakeTime = Hal_cycleCount() +
+        PANEL_DELAY_CYCLES(WAKE_UP_DELAY);
+
+    /* Start with a white buffer while the panel wakes up, the panel is not
+     * filled as the first frame sent overwrites all of it anyway */
     unsigned int i = 0;
     for(; i < LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT; ++i) {
-        LCD_writeData(0xff);
-        LCD_writeData(0xff);
-
         pixelBuffer[i] = 0xffff;
     }
 
-    /* Setup the pixelBufferOverlay so that its pointers point to the start of
-     * each row on the screen */
-    for(i = 0; i < LCD_SCREEN_HEIGHT; ++i) {
-        pixelBufferOverlay[i] = &pixelBuffer[i * LCD_SCREEN_WIDTH];
+    waited += waitUntil(panelAwakeTime);
+
+    // Run the set up sequence, the data bytes of a command go out back to back
+    i = 0;
+    while(i < sizeof(INIT_SEQUENCE)) {
+        LCD_writeCommand(INIT_SEQUENCE[i++]);
+        uint8_t numData = INIT_SEQUENCE[i] & ~INIT_DELAY;
+        uint8_t delay = INIT_SEQUENCE[i++] & INIT_DELAY;
+        COUNT_WORK(spiBytes, numData);
+        for(; numData > 0; --numData) {
+            Hal_panelWriteData(INIT_SEQUENCE[i++]);
+        }
+        if(delay) {
+            waitUntil(Hal_cycleCount() +
+                PANEL_DELAY_CYCLES(INIT_SEQUENCE[i++]));
+        }
     }
+    return waited;
+}
 
-    LCD_DELAY(10);
-    // Turn the display on
+void LCD_displayOn() {
+    /* Sending a whole frame takes far longer than the delay the panel needs
+     * after the set up sequence */
     LCD_writeCommand(LCD_CMD_DISPLAY_ON);
 }
 
+void LCD_init() {
+    LCD_initStart();
+    LCD_initFinish();
+    LCD_displayOn();
+}
+
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
 LCD_Error_t
 #else
@@ -176,12 +174,12 @@ void
 LCD_drawPixel(int16_t x, int16_t y) {
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
     if(x >= 0 && x < LCD_SCREEN_WIDTH && y >= 0 && y < LCD_SCREEN_HEIGHT) {
-        pixelBufferOverlay[y][x] = foregroundColor;
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_PIXEL, x, y);
         return LCD_NO_ERROR;
     }
     return LCD_OUT_OF_BOUNDS;
 #else
-    pixelBufferOverlay[y][x] = foregroundColor;
+    WRITE_PIXEL(COUNTERS_PRIMITIVE_PIXEL, x, y);
 #endif
 }
 
@@ -222,7 +220,7 @@ LCD_fillRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
         unsigned int y;
         for(y = yMin; y <= yMax; ++y) {
             for(x = xMin; x <= xMax; ++x) {
-                pixelBufferOverlay[y][x] = foregroundColor;
+                WRITE_PIXEL(COUNTERS_PRIMITIVE_FILL_RECT, x, y);
             }
         }
 
@@ -240,8 +238,8 @@ void
 #endif
 LCD_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
-    if(x0 < 0 || x0 >= LCD_SCREEN_WIDTH || y0 < 0 && y0 >= LCD_SCREEN_HEIGHT ||
-       x1 < 0 || x1 >= LCD_SCREEN_WIDTH || y1 < 0 && y1 >= LCD_SCREEN_HEIGHT) {
+    if(x0 < 0 || x0 >= LCD_SCREEN_WIDTH || y0 < 0 || y0 >= LCD_SCREEN_HEIGHT ||
+       x1 < 0 || x1 >= LCD_SCREEN_WIDTH || y1 < 0 || y1 >= LCD_SCREEN_HEIGHT) {
         return LCD_OUT_OF_BOUNDS;
     }
 #endif
@@ -265,7 +263,7 @@ LCD_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
         float error = 0.f;
         float slope = (float)deltaY / deltaX;
         while(x != x1) {
-            pixelBufferOverlay[y][x] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_LINE, x, y);
             x += xAdv;
             error += slope;
             if(error >= 1.f) {
@@ -280,7 +278,7 @@ LCD_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
         float error = 0.f;
         float slope = (float)deltaX / deltaY;
         while(y != y1) {
-            pixelBufferOverlay[y][x] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_LINE, x, y);
             y += yAdv;
             error += slope;
             if(error >= 1.f) {
@@ -320,7 +318,7 @@ LCD_drawLineVertical(int16_t x, int16_t y0, int16_t y1) {
     }
 
     for(; yMin <= yMax; ++yMin) {
-        pixelBufferOverlay[yMin][x] = foregroundColor;
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_LINE_VERTICAL, x, yMin);
     }
 
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
@@ -353,7 +351,7 @@ LCD_drawLineHorizontal(int16_t x0, int16_t x1, int16_t y) {
     }
 
     for(; xMin <= xMax; ++xMin) {
-        pixelBufferOverlay[y][xMin] = foregroundColor;
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_LINE_HORIZONTAL, xMin, y);
     }
 
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
@@ -361,6 +359,7 @@ LCD_drawLineHorizontal(int16_t x0, int16_t x1, int16_t y) {
 #endif
 }
 
+RAMFUNC
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
 LCD_Error_t
 #else
@@ -380,20 +379,20 @@ LCD_drawCircle(int16_t centerX, int16_t centerY, int16_t r) {
 
     while(x >= y) {
         // First quadrant
-        pixelBufferOverlay[centerY + y][centerX + x] = foregroundColor;
-        pixelBufferOverlay[centerY + x][centerX + y] = foregroundColor;
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX + x, centerY + y);
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX + y, centerY + x);
 
         // Second quadrant
-        pixelBufferOverlay[centerY + y][centerX - x] = foregroundColor;
-        pixelBufferOverlay[centerY + x][centerX - y] = foregroundColor;
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX - x, centerY + y);
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX - y, centerY + x);
 
         // Third quadrant
-        pixelBufferOverlay[centerY - y][centerX - x] = foregroundColor;
-        pixelBufferOverlay[centerY - x][centerX - y] = foregroundColor;
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX - x, centerY - y);
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX - y, centerY - x);
 
         // Fourth quadrant
-        pixelBufferOverlay[centerY - y][centerX + x] = foregroundColor;
-        pixelBufferOverlay[centerY - x][centerX + y] = foregroundColor;
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX + x, centerY - y);
+        WRITE_PIXEL(COUNTERS_PRIMITIVE_CIRCLE, centerX + y, centerY - x);
 
         ++y;
         error += 1 + 2 * y;
@@ -421,6 +420,12 @@ LCD_fillCircle(int16_t centerX, int16_t centerY, int16_t r) {
     }
 #endif
 
+#ifdef COUNTERS_DEBUG
+    // The lines below count as pixels of the filled circle
+    uint32_t linePixels =
+        workCounters.pixels[COUNTERS_PRIMITIVE_LINE_VERTICAL];
+#endif
+
     int x = r;
     int y = 0;
     int error = 0;
@@ -442,6 +447,13 @@ LCD_fillCircle(int16_t centerX, int16_t centerY, int16_t r) {
         }
     }
 
+#ifdef COUNTERS_DEBUG
+    linePixels = workCounters.pixels[COUNTERS_PRIMITIVE_LINE_VERTICAL] -
+        linePixels;
+    workCounters.pixels[COUNTERS_PRIMITIVE_LINE_VERTICAL] -= linePixels;
+    workCounters.pixels[COUNTERS_PRIMITIVE_FILL_CIRCLE] += linePixels;
+#endif
+
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
     return LCD_NO_ERROR;
 #endif
@@ -452,6 +464,7 @@ LCD_fillCircle(int16_t centerX, int16_t centerY, int16_t r) {
 #define BOUND_X(val) (val >= xLowerBound && val <= xUpperBound)
 #define BOUND_Y(val) (val >= yLowerBound && val <= yUpperBound)
 
+RAMFUNC
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
 LCD_Error_t
 #else
@@ -470,10 +483,10 @@ LCD_drawArc(int16_t centerX, int16_t centerY, int16_t r, double startAngle, doub
     int16_t y = 0;
     int16_t error = 0;
 
-    int16_t x0 = (int16_t)(r * cos(startAngle));
-    int16_t x1 = (int16_t)(r * cos(endAngle));
-    int16_t y0 = (int16_t)(r * sin(startAngle));
-    int16_t y1 = (int16_t)(r * sin(endAngle));
+    int16_t x0 = (int16_t)(r * COUNTED_COS(startAngle));
+    int16_t x1 = (int16_t)(r * COUNTED_COS(endAngle));
+    int16_t y0 = (int16_t)(r * COUNTED_SIN(startAngle));
+    int16_t y1 = (int16_t)(r * COUNTED_SIN(endAngle));
 
     int16_t xLowerBound;
     int16_t yLowerBound;
@@ -524,34 +537,34 @@ LCD_drawArc(int16_t centerX, int16_t centerY, int16_t r, double startAngle, doub
     while(x >= y) {
         // First quadrant
         if(BOUND_X(x) && BOUND_Y(y)) {
-            pixelBufferOverlay[centerY + y][centerX + x] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX + x, centerY + y);
         }
         if(BOUND_X(y) && BOUND_Y(x)) {
-            pixelBufferOverlay[centerY + x][centerX + y] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX + y, centerY + x);
         }
 
         // Second quadrant
         if(BOUND_X(-x) && BOUND_Y(y)) {
-            pixelBufferOverlay[centerY + y][centerX - x] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX - x, centerY + y);
         }
         if(BOUND_X(-y) && BOUND_Y(x)) {
-            pixelBufferOverlay[centerY + x][centerX - y] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX - y, centerY + x);
         }
 
         // Third quadrant
         if(BOUND_X(-x) && BOUND_Y(-y)) {
-            pixelBufferOverlay[centerY - y][centerX - x] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX - x, centerY - y);
         }
         if(BOUND_X(-y) && BOUND_Y(-x)) {
-            pixelBufferOverlay[centerY - x][centerX - y] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX - y, centerY - x);
         }
 
         // Fourth quadrant
         if(BOUND_X(x) && BOUND_Y(-y)) {
-            pixelBufferOverlay[centerY - y][centerX + x] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX + x, centerY - y);
         }
         if(BOUND_X(y) && BOUND_Y(-x)) {
-            pixelBufferOverlay[centerY - x][centerX + y] = foregroundColor;
+            WRITE_PIXEL(COUNTERS_PRIMITIVE_ARC, centerX + y, centerY - x);
         }
 
         ++y;
@@ -572,15 +585,22 @@ LCD_drawArc(int16_t centerX, int16_t centerY, int16_t r, double startAngle, doub
 #undef BOUND_Y
 
 void LCD_clearBuffer() {
+    PROFILE_BEGIN(PROFILE_ZONE_CLEAR);
     /* Iterate through the elements of the buffer and set them to the
      * background color */
     unsigned int i;
     for(i = 0; i < LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT; ++i) {
         pixelBuffer[i] = backgroundColor;
     }
+    COUNT_PIXELS(COUNTERS_PRIMITIVE_CLEAR,
+        LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT);
+    PROFILE_END(PROFILE_ZONE_CLEAR);
 }
 
 void LCD_sendBuffer() {
+    // The frame is complete once it is sent
+    OVERDRAW_END_FRAME();
+    PROFILE_BEGIN(PROFILE_ZONE_SPI_SEND);
     // Iterate through the elements of the buffer and send them over SPI
     LCD_writeCommand(LCD_CMD_RAM_WRITE);
     unsigned int i;
@@ -589,9 +609,12 @@ void LCD_sendBuffer() {
         LCD_writeData(pixelBuffer[i] >> 8);
         LCD_writeData(pixelBuffer[i]);
     }
+    PROFILE_END(PROFILE_ZONE_SPI_SEND);
 }
 
-void LCD_sendAndClearBuffer() {
+RAMFUNC void LCD_sendAndClearBuffer() {
+    OVERDRAW_END_FRAME();
+    PROFILE_BEGIN(PROFILE_ZONE_SPI_SEND);
     // Send, then clear, the contents
     LCD_writeCommand(LCD_CMD_RAM_WRITE);
     unsigned int i;
@@ -601,6 +624,9 @@ void LCD_sendAndClearBuffer() {
 
         pixelBuffer[i] = backgroundColor;
     }
+    COUNT_PIXELS(COUNTERS_PRIMITIVE_CLEAR,
+        LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT);
+    PROFILE_END(PROFILE_ZONE_SPI_SEND);
 }
 
 void LCD_sendCustomBuffer(const uint8_t* buffer) {
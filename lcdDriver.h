@@ -17,8 +17,9 @@
 #define LCD_SCREEN_WIDTH 128
 #define LCD_SCREEN_HEIGHT 128
 
-// LCD delay utility function/macro used in initialization
-#define LCD_DELAY(delay) __delay_cycles((delay) * 48)
+/* The frame buffer is aligned to a row, so that a DMA transfer of whole rows
+ * can use word accesses and never straddles a row */
+#define LCD_FRAMEBUFFER_ALIGNMENT (LCD_SCREEN_WIDTH * 2)
 
 // LCD command macros
 #define LCD_CMD_SLEEP_OUT 0x11
@@ -42,6 +43,19 @@ typedef enum LCD_Error {
     LCD_OUT_OF_BOUNDS = 1
 } LCD_Error_t;
 
+/* The panel is brought up in two halves so that the time it needs after the
+ * reset can overlap the set up of the other peripherals. LCD_initStart sets up
+ * the SPI bus and resets the controller. LCD_initFinish waits out what is left
+ * of the reset recovery, wakes the panel up, fills the frame buffer while it
+ * wakes, sends the set up sequence and returns the MCLK cycles (nanoseconds on
+ * the host) it had to wait. The clock profile must not change in between.
+ * The display stays off, the panel RAM holds noise until the first frame is
+ * sent, after which LCD_displayOn turns it on. The frame buffer starts out
+ * white */
+void LCD_initStart();
+uint32_t LCD_initFinish();
+void LCD_displayOn();
+// All three in one, for callers with nothing to overlap
 void LCD_init();
 
 #ifdef LCD_PIXEL_DRAW_BOUNDS_CHECK
@@ -134,17 +148,23 @@ void LCD_sendCustomBuffer(const uint8_t* buffer);
 // Macro that creates a 16-bit color given the intensities
 #define MAKE_COLOR16(r, g, b) ((uint16_t)(((r) << 11) | ((g) << 5) | (b)))
 
+/* Frame buffer, one RGB565 pixel per element, row by row from the top left
+ * corner, and the pointers to the start of each of its rows, both live in the
+ * .framebuffer section */
+extern uint16_t pixelBuffer[LCD_SCREEN_HEIGHT * LCD_SCREEN_WIDTH];
+extern uint16_t* pixelBufferOverlay[LCD_SCREEN_HEIGHT];
+
 // Foreground and background colors
 extern uint16_t foregroundColor;
 extern uint16_t backgroundColor;
 
 // Function to set the foreground color, it is black by default
-inline void LCD_setForegroundColor(uint16_t color) {
+static inline void LCD_setForegroundColor(uint16_t color) {
     foregroundColor = color;
 }
 
 // Function to set the background color, it is white by default
-inline void LCD_setBackgroundColor(uint16_t color) {
+static inline void LCD_setBackgroundColor(uint16_t color) {
     backgroundColor = color;
 }
 
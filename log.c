@@ -0,0 +1,38 @@
+/*
+ * log.c
+ *
+ *  Created on: Dec 18, 2016
+ *      Author: boer8364
+ */
+
+#include "log.h"
+
+#if LOG_BACKEND_ENABLED
+
+#ifdef UART_DEBUG
+#include "uartLogger.h"
+#else
+#include "trace.h"
+#endif
+
+void Log_message(const char* message) {
+#ifdef UART_DEBUG
+    UART_Logger_sendString(message);
+    UART_Logger_sendByte((uint8_t)'\r');
+#else
+    Trace_log(message, 0);
+#endif
+}
+
+void Log_value(const char* message, int32_t value) {
+#ifdef UART_DEBUG
+    UART_Logger_sendString(message);
+    UART_Logger_sendString(": ");
+    UART_Logger_sendNumSigned(value);
+    UART_Logger_sendByte((uint8_t)'\r');
+#else
+    Trace_log(message, value);
+#endif
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * log.h
+ *
+ *  Created on: Dec 18, 2016
+ *      Author: boer8364
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+// Log levels, a module logs every message at or below its level
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+/* Per-module levels, these can be overridden on the command line, for example
+ * -DLOG_LEVEL_MAIN=LOG_LEVEL_DEBUG */
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_WARN
+#endif
+#ifndef LOG_LEVEL_MAIN
+#define LOG_LEVEL_MAIN LOG_LEVEL_INFO
+#endif
+#ifndef LOG_LEVEL_COUNTERS
+#define LOG_LEVEL_COUNTERS LOG_LEVEL_INFO
+#endif
+#ifndef LOG_LEVEL_OVERDRAW
+#define LOG_LEVEL_OVERDRAW LOG_LEVEL_INFO
+#endif
+
+/* Log messages go out as text over the UART with UART_DEBUG, or, in the
+ * trace-only mode (TRACE_RAM without UART_DEBUG), are recorded into the RAM
+ * trace as a pointer to the message and the value, without formatting. With
+ * neither, every level is compiled out */
+#if defined(UART_DEBUG) || defined(TRACE_RAM)
+#define LOG_BACKEND_ENABLED 1
+#else
+#define LOG_BACKEND_ENABLED 0
+#endif
+
+#if LOG_BACKEND_ENABLED
+// Logs a message
+void Log_message(const char* message);
+// Logs a message followed by a value, as "message: value"
+void Log_value(const char* message, int32_t value);
+#endif
+
+/* Waits until what was logged so far has been sent, reports longer than the
+ * UART logger buffer call it after every line so that nothing is dropped */
+#ifdef UART_DEBUG
+#include "uartLogger.h"
+#define LOG_FLUSH() UART_Logger_flush()
+#else
+#define LOG_FLUSH() ((void)0)
+#endif
+
+#endif /* LOG_H_ */
+
+/* The logging macros depend on the level of the module including this file,
+ * which defines LOG_MODULE_LEVEL first, so this part is redone for every
+ * translation unit. A message above the module's level compiles to nothing,
+ * its arguments are not evaluated, and the message string is not stored */
+#ifndef LOG_MODULE_LEVEL
+#define LOG_MODULE_LEVEL LOG_LEVEL_DEFAULT
+#endif
+
+#undef LOG_ERROR
+#undef LOG_ERROR_VALUE
+#undef LOG_WARN
+#undef LOG_WARN_VALUE
+#undef LOG_INFO
+#undef LOG_INFO_VALUE
+#undef LOG_DEBUG
+#undef LOG_DEBUG_VALUE
+
+#if LOG_BACKEND_ENABLED && LOG_MODULE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(message) Log_message(message)
+#define LOG_ERROR_VALUE(message, value) Log_value((message), (int32_t)(value))
+#else
+#define LOG_ERROR(message) ((void)0)
+#define LOG_ERROR_VALUE(message, value) ((void)0)
+#endif
+
+#if LOG_BACKEND_ENABLED && LOG_MODULE_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(message) Log_message(message)
+#define LOG_WARN_VALUE(message, value) Log_value((message), (int32_t)(value))
+#else
+#define LOG_WARN(message) ((void)0)
+#define LOG_WARN_VALUE(message, value) ((void)0)
+#endif
+
+#if LOG_BACKEND_ENABLED && LOG_MODULE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(message) Log_message(message)
+#define LOG_INFO_VALUE(message, value) Log_value((message), (int32_t)(value))
+#else
+#define LOG_INFO(message) ((void)0)
+#define LOG_INFO_VALUE(message, value) ((void)0)
+#endif
+
+#if LOG_BACKEND_ENABLED && LOG_MODULE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(message) Log_message(message)
+#define LOG_DEBUG_VALUE(message, value) Log_value((message), (int32_t)(value))
+#else
+#define LOG_DEBUG(message) ((void)0)
+#define LOG_DEBUG_VALUE(message, value) ((void)0)
+#endif
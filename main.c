@@ -5,222 +5,429 @@
 //****************************************************************************
 
 #include <inttypes.h>
-#include <stdlib.h>
 #include "bitmaps.h"
-#include "msp.h"
 #include "player.h"
 #include "wall.h"
 #include "collision.h"
 #include "globalMacros.h"
 #include "lcdDriver.h"
-#include "hardwareConfig.h"
-#include "myISR.h"
+#include "hal.h"
 #include "wallBuffer.h"
 #include "uartLogger.h"
+#include "simClock.h"
+#include "power.h"
+#include "clock.h"
+#include "prng.h"
+#include "pattern.h"
+#include "accelerometer.h"
+#include "input.h"
+#include "trace.h"
+#include "profiler.h"
+#include "replay.h"
+#include "counters.h"
+#include "overdraw.h"
+#include "lcdBenchmark.h"
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_MAIN
+#include "log.h"
 
 // Buffer holding wall objects
-volatile WallBuffer_t wallBuffer;
+WallBuffer_t wallBuffer;
+
+// The player
+static Player_t player;
+// The stationary boundary
+static Wall_t gameBoundary;
+// Random number generator used for the wall gaps
+static Prng_t wallPrng;
+// Interpreter for the wall wave patterns
+static PatternEngine_t patternEngine;
+/* Mapping from the tilt to the player velocity, without a dead zone or a
+ * curve this is the original linear response */
+static const InputConfig_t inputConfig = {
+    0,
+    NULL
+};
+// Time between walls in simulation ticks, drops as the difficulty goes up
+static uint8_t wallSpawnPeriod;
+
+// Builds the wall the pattern engine spawns on this tick, if any
+static void spawnWalls() {
+    PatternWall_t patternWall;
+    if(Pattern_tick(&patternEngine, wallSpawnPeriod, &patternWall)) {
+        /* Convert the gap positions, which are in the interval
+         * [0, WALL_ANGLE_GENERATION_RESOLUTION), to binary angles in the
+         * interval [-pi, pi) */
+        WallAngle_t gapStartAngles[WALL_MAX_GAPS];
+        uint8_t i = 0;
+        for(; i < patternWall.numGaps; ++i) {
+            gapStartAngles[i] = WALL_SECTOR_TO_ANGLE(patternWall.gap[i]);
+        }
+
+        // Add the new wall to the buffer
+        WallBuffer_addWall(&wallBuffer, gapStartAngles, patternWall.numGaps);
+        TRACE_EVENT(TRACE_EVENT_WALL_SPAWN,
+            ((uint32_t)patternWall.numGaps << 24) |
+            ((uint32_t)patternWall.gap[1] << 8) | patternWall.gap[0]);
+        LOG_DEBUG("Wall spawned");
+    }
+}
+
+/* Advances the game by one simulation tick, returns 1 if the player lost
+ * during this tick */
+static uint8_t simulateTick() {
+    TRACE_EVENT(TRACE_EVENT_TICK, wallBuffer.tick);
+    COUNT_WORK(ticks, 1);
+
+    // Build any walls that are due
+    PROFILE_BEGIN(PROFILE_ZONE_WALL_UPDATE);
+    spawnWalls();
+    PROFILE_END(PROFILE_ZONE_WALL_UPDATE);
+
+    // Get a fresh, filtered accelerometer reading
+    PROFILE_BEGIN(PROFILE_ZONE_INPUT);
+    AccelerometerReading_t reading;
+    Accelerometer_read(&reading);
+    // Record the reading, or swap in the recorded one
+    REPLAY_READING(&reading);
+    TRACE_EVENT(TRACE_EVENT_ADC_SAMPLE,
+        ((uint32_t)(uint16_t)reading.x << 16) | (uint16_t)reading.y);
+
+    LOG_DEBUG_VALUE("X", reading.x);
+    LOG_DEBUG_VALUE("Y", reading.y);
+
+    // Map the tilt to a velocity vector in integer math
+    InputVelocity_t velocity;
+    Input_map(&inputConfig, &reading, &velocity);
+    Vector2d_t movementVector = {
+        INPUT_VELOCITY_TO_DOUBLE(velocity.x),
+        INPUT_VELOCITY_TO_DOUBLE(velocity.y)
+    };
+    PROFILE_END(PROFILE_ZONE_INPUT);
+
+    /* ***** Collision checking section ***** */
+    PROFILE_BEGIN(PROFILE_ZONE_COLLISION);
+
+    // Take a snapshot of the walls
+    WallBufferSnapshot_t walls;
+    WallBuffer_takeSnapshot(&wallBuffer, &walls);
+
+    // Check if there is anything in the buffer
+    if(walls.numItems > 0) {
+        /* The inner-most wall is at the tail, so just check the tail,
+         * sweep the player along its whole movement for this tick so
+         * that large steps can not tunnel through the wall */
+        Wall_t innerWall;
+        WallBuffer_getSnapshotWall(&walls, 0, &innerWall);
+        double timeOfImpact;
+        CollisionCode_t collisionResult = sweptCollision(&player,
+            &movementVector, &innerWall, WALL_SPEED, &timeOfImpact);
+
+        // Handle the collision accordingly
+        if(collisionResult != NO_COLLISION) {
+            TRACE_EVENT(TRACE_EVENT_COLLISION, collisionResult);
+        }
+        if(collisionResult == WALL_COLLISION) {
+            if(timeOfImpact > 0.0) {
+                /* The player will hit the wall during this tick, so
+                 * stop it at the point of impact */
+                Vector2d_selfScale(&movementVector, timeOfImpact);
+            } else {
+                /* Calculate a normal vector to add to the movement
+                 * vector so that the player does not bypass the wall */
+                Vector2d_t normalVector = calculateNormalVector(&player,
+                    &movementVector, WALL_SPEED);
+                // Add the calculated normal vector
+                Vector2d_selfAdd(&movementVector, &normalVector);
+            }
+        } else if(collisionResult == GAP_COLLISION) {
+            // If the player breached the wall, despawn it
+            WallBuffer_removeWall(&wallBuffer);
+            WallBuffer_takeSnapshot(&wallBuffer, &walls);
+            TRACE_EVENT(TRACE_EVENT_WALL_DESPAWN, walls.numItems);
+            LOG_DEBUG("Wall despawned");
+
+            /* Increase the difficulty of the game, if it is not at
+             * maximum difficulty yet */
+            if(wallSpawnPeriod > WALL_SPAWN_PERIOD_MIN) {
+                // Drop the wall spawn period (speed up spawning)
+                wallSpawnPeriod -= WALL_SPAWN_PERIOD_DECREMENT;
+            }
+        }
+    }
+
+    // Check if the player collided with the outer, stationary wall
+    double boundaryTimeOfImpact;
+    CollisionCode_t boundaryCollision = sweptCollision(&player,
+        &movementVector, &gameBoundary, 0, &boundaryTimeOfImpact);
+    if(boundaryCollision == WALL_COLLISION) {
+        if(boundaryTimeOfImpact > 0.0) {
+            // Stop the player where it meets the boundary
+            Vector2d_selfScale(&movementVector, boundaryTimeOfImpact);
+        } else {
+            /* Calculate a normal vector for the stationary wall so
+             * that it does not go out of bounds */
+            Vector2d_t normalVector = calculateNormalVector(&player,
+                &movementVector, 0);
+            // Add the normal vector to the movement vector
+            Vector2d_selfAdd(&movementVector, &normalVector);
+        }
+    }
+    PROFILE_END(PROFILE_ZONE_COLLISION);
+
+    // Move the player using the calculated movement vector
+    Player_move(&player, &movementVector);
+
+    /* Close the walls in at the according speed, the radii are derived from
+     * the tick so this does not touch the walls themselves */
+    WallBuffer_advanceTick(&wallBuffer);
+    walls.tick = wallBuffer.tick;
+
+    // If the last wall (the tail) closes in, the player loses
+    return walls.numItems > 0 &&
+        WallBuffer_getSnapshotRadius(&walls, 0) <= PLAYER_RADIUS + 1;
+}
+
+#ifdef INPUT_REPLAY
+// Adds length bytes to an FNV-1a hash
+static uint32_t hashBytes(uint32_t hash, const void* data, uint32_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t i = 0;
+    for(; i < length; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Checksum of the state a replay has to reproduce, FNV-1a over the player
+ * position, the difficulty, the wall buffer indices and tick, and the gaps
+ * and spawn ticks of the walls still in the buffer */
+static uint32_t stateChecksum() {
+    uint32_t hash = hashBytes(2166136261u, &player.position,
+        sizeof(player.position));
+    hash = hashBytes(hash, &wallSpawnPeriod, sizeof(wallSpawnPeriod));
+    uint32_t head = wallBuffer.index.head;
+    uint32_t tail = wallBuffer.index.tail;
+    uint8_t tick = wallBuffer.tick;
+    hash = hashBytes(hash, &head, sizeof(head));
+    hash = hashBytes(hash, &tail, sizeof(tail));
+    hash = hashBytes(hash, &tick, sizeof(tick));
+
+    WallBufferSnapshot_t walls;
+    WallBuffer_takeSnapshot(&wallBuffer, &walls);
+    uint32_t i = 0;
+    for(; i < walls.numItems; ++i) {
+        uint32_t index = (walls.tail + i) &
+            RING_BUFFER_MASK(WALL_BUFFER_SIZE_LOG2);
+        uint8_t numGaps = wallBuffer.numGaps[index];
+        hash = hashBytes(hash, &numGaps, sizeof(numGaps));
+        hash = hashBytes(hash, &wallBuffer.spawnTick[index],
+            sizeof(wallBuffer.spawnTick[index]));
+        uint8_t gap = 0;
+        for(; gap < numGaps; ++gap) {
+            hash = hashBytes(hash, &wallBuffer.gapStartAngle[gap][index],
+                sizeof(WallAngle_t));
+        }
+    }
+    return hash;
+}
+#endif
+
+// Draws the current state of the game and sends it to the LCD
+static void renderFrame() {
+    // Draw the boundary wall
+    PROFILE_BEGIN(PROFILE_ZONE_DRAW_BOUNDARY);
+    Wall_draw(&gameBoundary);
+    PROFILE_END(PROFILE_ZONE_DRAW_BOUNDARY);
+
+    // Draw the walls in the wall buffer
+    PROFILE_BEGIN(PROFILE_ZONE_DRAW_WALLS);
+    WallBufferSnapshot_t walls;
+    WallBuffer_takeSnapshot(&wallBuffer, &walls);
+    uint32_t i = 0;
+    for(; i < walls.numItems; ++i) {
+        Wall_t wall;
+        WallBuffer_getSnapshotWall(&walls, i, &wall);
+        Wall_draw(&wall);
+    }
+    COUNT_WORK(wallsDrawn, walls.numItems);
+    PROFILE_END(PROFILE_ZONE_DRAW_WALLS);
+
+    // Draw the player
+    PROFILE_BEGIN(PROFILE_ZONE_DRAW_PLAYER);
+    Player_draw(&player);
+    PROFILE_END(PROFILE_ZONE_DRAW_PLAYER);
+
+    // Send the buffer contents to the LCD
+    LCD_sendAndClearBuffer();
+}
 
 void main(void)
 {
+    // Stop the watchdog and set up the clocks
+    Hal_init();
+    // Start of the boot, the first frame reports the time since
+    uint32_t bootStart = Hal_cycleCount();
 
-    WDTCTL = WDTPW | WDTHOLD;           // Stop watchdog timer
+    /* Reset and wake up the panel first, the rest of the set up runs while
+     * it wakes up */
+    LCD_initStart();
 
-    // Initialize the player
-    Player_t player;
     // Start the player in the center of the screen
     Vector2d_t initialPlayerPosition = {
         ((double)LCD_SCREEN_WIDTH) / 2.0,
         ((double)LCD_SCREEN_HEIGHT) / 2.0
     };
+    // Initialize the player
     Player_init(&player, &initialPlayerPosition);
 
     // Initialize the wall buffer
-    WallBuffer_init((WallBuffer_t*)&wallBuffer, WALL_BUFFER_SIZE);
+    WallBuffer_init(&wallBuffer);
 
     // Create the stationary boundary
-    Wall_t gameBoundary;
     // Do not have a gap, this keeps the player from leaving the screen
     Wall_init(&gameBoundary, 0.0, 0.0);
 
     // Configure peripherals
-    configureADC();
-    configureTimer();
-    configurePins();
+    Hal_adcInit();
+    Hal_simTimerInit();
+    Hal_buttonInit();
+    PROFILE_INIT();
 
 #ifdef UART_DEBUG
-    configureUART();
+    Hal_uartInit();
 #endif
 
-    enableButtonInterrupts();
-    LCD_init();
+    Hal_buttonEnable();
+    // Finish the panel set up, waiting for whatever is left of its wake up
+    uint32_t panelWait = LCD_initFinish();
 
     // Prepare the game background color
     LCD_setBackgroundColor(MAKE_COLOR16(0, 0, 31));
 
+#if defined(INPUT_REPLAY) && !defined(HOST_BUILD)
+    // Play back the stream built into the image, or record a new one
+    if(replayStreamLength) {
+        Replay_startPlayback(replayStream, replayStreamLength);
+    } else {
+        Replay_startRecording();
+    }
+#endif
+
     // Globally enable interrupts
-    __enable_interrupt();
+    ENABLE_INTERRUPTS();
+
+#ifdef LCD_BENCHMARK
+    // Time the drawing primitives, the UART needs the interrupts to drain
+    Clock_setProfile(CLOCK_PROFILE_GAME);
+    LcdBenchmark_run(LCD_BENCHMARK_CSV);
+    Clock_setProfile(CLOCK_PROFILE_SCREENS);
+#endif
 
+    // Set until the first frame is on the panel
+    uint8_t booting = 1;
     while(1) {
         // Draw the title screen
         LCD_sendCustomBuffer(START_SCREEN_BITMAP);
-        // Block until the button has been pressed
-        while(!buttonPressed);
+        if(booting) {
+            // The panel stays dark until it has a whole frame to show
+            LCD_displayOn();
+            PROFILE_FIRST_FRAME(bootStart, panelWait);
+            booting = 0;
+        }
+        // Sleep until the button has been pressed
+        POWER_SLEEP_WHILE(!REPLAY_BUTTON(buttonPressed), POWER_TITLE_MODE);
         // Disable button interrupts
-        disableButtonInterrupts();
-
-        // Seed the random number generator
-        srand((unsigned int)TIMER_A0->R);
-
-        // Rest the timer count
-        resetTimer();
-        // Enable timer interrupts
-        enableTimerInterrupts();
-
+        Hal_buttonDisable();
+        // Speed the clocks up for the game
+        Clock_setProfile(CLOCK_PROFILE_GAME);
+
+        /* Seed the random number generator from the simulation clock, it
+         * counted through the wait on the title screen (LPM0 leaves ACLK
+         * running), so the seed depends on when the button was pressed */
+        Prng_seed(&wallPrng, REPLAY_SEED(SimClock_now()));
+        TRACE_EVENT(TRACE_EVENT_GAME_START, wallPrng.state);
+
+        // Start at minimum difficulty, the first wall comes one period in
+        wallSpawnPeriod = WALL_SPAWN_PERIOD_MAX;
+        Pattern_start(&patternEngine, &wallPrng, wallSpawnPeriod);
+        // Start sampling the accelerometer
+        Accelerometer_start();
+        // Start simulating from a clean clock
+        SimClock_reset();
+        Power_resetStats();
+        PROFILE_RESET();
+        COUNTERS_RESET();
+        OVERDRAW_RESET();
+
+        uint8_t gameOver = 0;
         while(1) {
-
-#ifdef TIMING_INFO_DEBUG
-#ifndef UART_DEBUG
-            // Stop the timer
-            TIMER_A1->CTL &= ~TIMER_A_CTL_MC_3;
-#endif
-            TIMER_A1->R = 0;
-#ifndef UART_DEBUG
-            // Start the timer
-            TIMER_A1->CTL |= TIMER_A_CTL_MC_2;
-#endif
-#endif
-
-            // Request an ADC sample at the start of the game loop
-            ADC14->CTL0 |= ADC14_CTL0_SC;
-
-            // Compute gravity vector using the latest ADC samples
-            Vector2d_t movementVector = {
-                (double)adc14Readings.lastXReading,
-                (double)-adc14Readings.lastYReading
-            };
-
-            /* Set the magnitude of the vector so that it can be used as a
-             * proper velocity vector directly */
-            double accelerometerMagnitude = Vector2d_getMagnitude(&movementVector);
-            double movementMagnitude = (PLAYER_SPEED * accelerometerMagnitude) / HARDWARE_CONFIG_ADC_MAX_MAGNITUDE;
-            Vector2d_setMagnitude(&movementVector, movementMagnitude);
-
-            /* ***** Collision checking section ***** */
-
-            // Check if there is anything in the buffer
-            if(wallBuffer.numItems > 0) {
-                // The inner-most wall is at the tail, so just check the tail
-                CollisionCode_t collisionResult = collision(&player,
-                    (Wall_t*)wallBuffer.tail);
-
-                // Handle the collision accordingly
-                if(collisionResult == WALL_COLLISION) {
-                    /* Calculate a normal vector to add to the movement vector
-                     * so that the player does not bypass the wall */
-                    Vector2d_t normalVector = calculateNormalVector(&player,
-                        &movementVector, WALL_SPEED);
-                    // Add the calculated normal vector
-                    Vector2d_selfAdd(&movementVector, &normalVector);
-                } else if(collisionResult == GAP_COLLISION) {
-                    // If the player breached the wall, despawn it
-                    WallBuffer_removeWall((WallBuffer_t*)&wallBuffer, NULL);
-
-#ifdef UART_DEBUG
-                    UART_Logger_sendString("Wall Despawned\r");
-#endif
-
-                    /* Increase the difficulty of the game, if it is not at
-                     * maximum difficulty yet */
-                    if(TIMER_A0->CCR[0] > WALL_SPAWN_PERIOD_MIN) {
-                        // Disable timer interrupts when changing settings
-                        disableTimerInterrupts();
-
-                        // Drop the wall spawn period (speed up spawning)
-                        TIMER_A0->CCR[0] -= WALL_SPAWN_PERIOD_DECREMENT;
-
-                        /* Check if the current timer count is above the new
-                         * threshold */
-                        if(TIMER_A0->R > TIMER_A0->CCR[0]) {
-                            /* This should guarantee the timer count will be
-                             * below the threshold */
-                            TIMER_A0->R -= WALL_SPAWN_PERIOD_DECREMENT;
-                        }
-
-                        // Re-enable timer interrupts
-                        enableTimerInterrupts();
-                    }
-                }
-            }
-
-            // Check if the player collided with the outer, stationary wall
-            CollisionCode_t boundaryCollision = collision(&player, &gameBoundary);
-            if(boundaryCollision == WALL_COLLISION) {
-                /* Calculate a normal vector for the stationary wall so that
-                 * it does not go out of bounds */
-                Vector2d_t normalVector = calculateNormalVector(&player,
-                    &movementVector, 0);
-                // Add the normal vector to the movement vector
-                Vector2d_selfAdd(&movementVector, &normalVector);
+            /* Run one simulation tick for every tick of the simulation clock
+             * that elapsed, so that the game speed does not depend on how
+             * long the frame takes to draw */
+            uint16_t ticks = SimClock_beginFrame();
+            TRACE_EVENT(TRACE_EVENT_FRAME_START, ticks);
+            // Time the work of the frame, not the wait for the tick
+            PROFILE_BEGIN(PROFILE_ZONE_FRAME);
+            for(; ticks > 0 && !gameOver; --ticks) {
+                gameOver = simulateTick();
             }
 
-            // Move the player using the calculated movement vector
-            Player_move(&player, &movementVector);
-
-            // Draw the boundary wall
-            Wall_draw(&gameBoundary);
-
-            // Draw the walls in the wall buffer
-            // Iterator pointer
-            Wall_t* iter = (Wall_t*)wallBuffer.tail;
-            unsigned int i = 0;
-            for(; i < wallBuffer.numItems; ++i) {
-                // Close the walls in at the according speed
-                iter->radius -= WALL_SPEED;
-                // Draw the wall
-                Wall_draw(iter);
-                // Advance the iterator pointer
-                advanceBufferPointer((WallBuffer_t*)&wallBuffer, &iter);
-            }
-
-            // If the last wall (the tail) closes in, the player loses
-            if(wallBuffer.numItems > 0 &&
-               wallBuffer.tail->radius <= PLAYER_RADIUS + 1) {
-                /* Disable timer interrupts: there is no need to spawn anymore
-                 * walls */
-                disableTimerInterrupts();
+            if(gameOver) {
+                TRACE_EVENT(TRACE_EVENT_GAME_OVER, simClockStats.totalTicks);
+                REPLAY_GAME_OVER(stateChecksum());
+                // Stop sampling, the screens in between games do not need it
+                Accelerometer_stop();
+                // Slow the clocks back down for the screens
+                Clock_setProfile(CLOCK_PROFILE_SCREENS);
                 // Clear the contents of the wall buffer
-                WallBuffer_emptyBuffer((WallBuffer_t*)&wallBuffer);
+                WallBuffer_emptyBuffer(&wallBuffer);
                 // Leave the game loop
                 break;
             }
 
-            // Draw the player
-            Player_draw(&player);
-
-            // Send the buffer contents to the LCD
-            LCD_sendAndClearBuffer();
-
+            // Skip the drawing if the simulation is falling behind
+            uint8_t rendered = !SimClock_shouldSkipRender();
+            if(rendered) {
+                renderFrame();
+            }
+            SimClock_endFrame(rendered);
+            PROFILE_END(PROFILE_ZONE_FRAME);
+            COUNTERS_END_FRAME();
+            TRACE_EVENT(TRACE_EVENT_FRAME_END, rendered);
+
+            // Report the frame time and the number of ticks it simulated
+            LOG_DEBUG_VALUE("Frame time", simClockStats.lastFrameTime);
+            LOG_DEBUG_VALUE("Frame ticks", simClockStats.lastTicksPerFrame);
+        }
+        // Report how much of the game was spent awake
+        LOG_INFO_VALUE("Active", Power_getActiveTime());
+        LOG_INFO_VALUE("Asleep", powerStats.sleepTime);
+        // Dump the zone timings, the work counts and overdraw of the game
+        PROFILE_REPORT();
+        COUNTERS_REPORT();
+        OVERDRAW_REPORT();
 #ifdef UART_DEBUG
-#ifdef TIMING_INFO_DEBUG
-            UART_Logger_sendByte((uint8_t)'[');
-            UART_Logger_sendNumSigned((int32_t)TIMER_A1->R);
-            UART_Logger_sendString("] ");
+        // Report how much of the log, the reports included, did not fit
+        LOG_INFO_VALUE("Log bytes dropped", uartLoggerDroppedBytes);
 #endif
-            UART_Logger_sendString("End of frame\r");
-#endif
-        }
+
         // Re-enable button interrupts to get passed the game over screen
-        enableButtonInterrupts();
+        Hal_buttonEnable();
         // Draw the game over screen
         LCD_sendCustomBuffer(END_SCREEN_BITMAP);
 
-        // Block until the button is pushed
-        while(!buttonPressed);
+#ifdef UART_DEBUG
+        /* The eUSCI runs off ACLK, which LPM3 stops, so let the reports go
+         * out in LPM0 first, a press in the meantime is kept in the flag */
+        UART_Logger_flush();
+        /* Then the last byte, nothing interrupts when it is out, the
+         * simulation timer wakes the CPU up to check */
+        POWER_SLEEP_WHILE(Hal_uartBusy(), POWER_MODE_LPM0);
+#endif
+        // Sleep until the button is pushed
+        POWER_SLEEP_WHILE(!REPLAY_BUTTON(buttonPressed), POWER_IDLE_MODE);
         // Reset the button interrupt
         buttonPressed = 0;
-
-        // Reset the timer threshold to minimum difficulty
-        TIMER_A0->CCR[0] = WALL_SPAWN_PERIOD_MAX;
     }
 }
@@ -0,0 +1,50 @@
+/*
+ * memoryBudget.c
+ *
+ *  Created on: Dec 22, 2016
+ *      Author: boer8364
+ */
+
+#include "memoryBudget.h"
+
+#ifndef HOST_BUILD
+
+#include "lcdDriver.h"
+#include "overdraw.h"
+#include "replay.h"
+#include "lcdBenchmark.h"
+
+/* Fails the compile with a negative array size when the condition does not
+ * hold, the name says which budget was exceeded */
+#define MEMORY_BUDGET_CHECK(name, condition) \
+    typedef char memoryBudgetExceeded_##name[(condition) ? 1 : -1]
+
+// Sizes of the buffers of each section with the current debug flags
+#define FRAMEBUFFER_SIZE (sizeof(pixelBuffer) + sizeof(pixelBufferOverlay))
+
+#ifdef OVERDRAW_DEBUG
+#define OVERDRAW_SIZE sizeof(overdrawCount)
+#else
+#define OVERDRAW_SIZE 0
+#endif
+#ifdef INPUT_REPLAY
+#define REPLAY_SIZE sizeof(replayBuffer)
+#else
+#define REPLAY_SIZE 0
+#endif
+#ifdef LCD_BENCHMARK
+#define BENCHMARK_SIZE sizeof(lcdBenchmarkResults)
+#else
+#define BENCHMARK_SIZE 0
+#endif
+#define DEBUG_BUFFERS_SIZE (OVERDRAW_SIZE + REPLAY_SIZE + BENCHMARK_SIZE)
+
+MEMORY_BUDGET_CHECK(framebuffer,
+    FRAMEBUFFER_SIZE <= MEMORY_BUDGET_FRAMEBUFFER);
+MEMORY_BUDGET_CHECK(debugBuffers,
+    DEBUG_BUFFERS_SIZE <= MEMORY_BUDGET_DEBUG_BUFFERS);
+MEMORY_BUDGET_CHECK(ram, MEMORY_BUDGET_FRAMEBUFFER +
+    MEMORY_BUDGET_DEBUG_BUFFERS + MEMORY_BUDGET_OTHER + MEMORY_BUDGET_RAMFUNC +
+    MEMORY_STACK_SIZE <= MEMORY_RAM_SIZE);
+
+#endif
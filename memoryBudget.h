@@ -0,0 +1,41 @@
+/*
+ * memoryBudget.h
+ *
+ *  Created on: Dec 22, 2016
+ *      Author: boer8364
+ */
+
+#ifndef MEMORYBUDGET_H_
+#define MEMORYBUDGET_H_
+
+#include "globalMacros.h"
+
+/* RAM budget of the target, checked at compile time by memoryBudget.c
+ * against the sizes of the statically allocated buffers, so that a build
+ * that turns on too many debug buffers fails to compile instead of failing
+ * to link or running out of stack. Nothing is allocated from the heap, the
+ * CCS project sets the heap size to 0. What the compiler can not see, such as
+ * the rest of .data and .bss and the SRAM code, is checked after linking:
+ * tools/memReport.c, a post-build step of the CCS project, measures every
+ * section of the linker map against these budgets and fails the build (the
+ * step needs a host gcc, it is skipped without one) */
+
+// SRAM of the MSP432P401R
+#define MEMORY_RAM_SIZE (64 * 1024)
+// Stack, the linker option of the CCS project
+#define MEMORY_STACK_SIZE 512
+
+// The frame buffer and its row pointers, the .framebuffer section
+#define MEMORY_BUDGET_FRAMEBUFFER (33 * 1024)
+/* Debug buffers (overdraw counts, replay recording, benchmark results), the
+ * .debugbuffers section. With every one on it holds 16K of overdraw counts,
+ * the 4K recording (about 30 seconds of play, see replay.h) and 1280 bytes
+ * of benchmark results */
+#define MEMORY_BUDGET_DEBUG_BUFFERS (22 * 1024)
+// Everything else, .data, .bss and .vtable
+#define MEMORY_BUDGET_OTHER (6 * 1024)
+/* Code copied into SRAM at start-up, the RAMFUNC functions in the .TI.ramfunc
+ * section, its size is only known after linking */
+#define MEMORY_BUDGET_RAMFUNC (2 * 1024)
+
+#endif /* MEMORYBUDGET_H_ */
@@ -89,12 +89,22 @@ SECTIONS
     .vtable :   > 0x20000000
     .data   :   > SRAM_DATA
     .bss    :   > SRAM_DATA
+    /* The game does not allocate, the CCS project sets the heap size to 0 */
     .sysmem :   > SRAM_DATA
+
+    /* Statically allocated buffers, see memoryBudget.h, the code that owns
+     * them writes them before reading them so they are not zero-initialized,
+     * the frame buffer alignment comes from its declaration */
+    .framebuffer  : > SRAM_DATA, type = NOINIT
+    .debugbuffers : > SRAM_DATA, type = NOINIT
     .stack  :   > SRAM_DATA (HIGH)
 
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
-    .TI.ramfunc : {} load=MAIN, run=SRAM_CODE, table(BINIT)
+    /* RAMFUNC code, see globalMacros.h, the boot code copies it from flash
+     * into SRAM through the BINIT table, the symbols give its SRAM range */
+    .TI.ramfunc : {} load=MAIN, run=SRAM_CODE, table(BINIT),
+                     RUN_START(ramfuncRunStart), SIZE(ramfuncSize)
 #endif
 #endif
 }
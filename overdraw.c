@@ -0,0 +1,174 @@
+/*
+ * overdraw.c
+ *
+ *  Created on: Dec 21, 2016
+ *      Author: boer8364
+ */
+
+#include "overdraw.h"
+
+#ifdef OVERDRAW_DEBUG
+
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
+
+#define LOG_MODULE_LEVEL LOG_LEVEL_OVERDRAW
+#include "log.h"
+
+#define OVERDRAW_PIXELS (LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT)
+
+// Cleared by Overdraw_reset before the first frame of a game
+uint8_t overdrawCount[OVERDRAW_PIXELS] MEMORY_SECTION(".debugbuffers");
+OverdrawStats_t overdrawFrame;
+OverdrawStats_t overdrawTotal;
+uint32_t overdrawFrames;
+
+static const char* const BIN_NAMES[OVERDRAW_HISTOGRAM_BINS] = {
+    "written 0x",
+    "written 1x",
+    "written 2x",
+    "written 3x",
+    "written 4x",
+    "written 5x",
+    "written 6x",
+    "written 7x",
+    "written 8x+"
+};
+
+#ifdef HOST_BUILD
+uint8_t overdrawWorstCount[OVERDRAW_PIXELS];
+// Redundant writes of the frame in overdrawWorstCount
+static uint32_t worstRedundantWrites;
+
+// Heatmap colors of the histogram bins, red, green, blue
+static const uint8_t BIN_COLORS[OVERDRAW_HISTOGRAM_BINS][3] = {
+    {0, 0, 0},
+    {0, 0, 160},
+    {0, 160, 0},
+    {160, 160, 0},
+    {255, 160, 0},
+    {255, 80, 0},
+    {255, 0, 0},
+    {255, 0, 160},
+    {255, 255, 255}
+};
+#endif
+
+static void clearStats(OverdrawStats_t* stats) {
+    uint8_t bin = 0;
+    for(; bin < OVERDRAW_HISTOGRAM_BINS; ++bin) {
+        stats->histogram[bin] = 0;
+    }
+    stats->writes = 0;
+    stats->redundantWrites = 0;
+    stats->maxWrites = 0;
+}
+
+void Overdraw_endFrame() {
+    clearStats(&overdrawFrame);
+    uint32_t i = 0;
+    for(; i < OVERDRAW_PIXELS; ++i) {
+        uint8_t count = overdrawCount[i];
+        ++overdrawFrame.histogram[count < OVERDRAW_HISTOGRAM_BINS - 1 ?
+            count : OVERDRAW_HISTOGRAM_BINS - 1];
+        overdrawFrame.writes += count;
+        if(count > 1) {
+            overdrawFrame.redundantWrites += count - 1;
+        }
+        if(count > overdrawFrame.maxWrites) {
+            overdrawFrame.maxWrites = count;
+        }
+    }
+
+    uint8_t bin = 0;
+    for(; bin < OVERDRAW_HISTOGRAM_BINS; ++bin) {
+        overdrawTotal.histogram[bin] += overdrawFrame.histogram[bin];
+    }
+    overdrawTotal.writes += overdrawFrame.writes;
+#ifdef HOST_BUILD
+    if(!overdrawFrames ||
+        overdrawFrame.redundantWrites > worstRedundantWrites) {
+        worstRedundantWrites = overdrawFrame.redundantWrites;
+        for(i = 0; i < OVERDRAW_PIXELS; ++i) {
+            overdrawWorstCount[i] = overdrawCount[i];
+        }
+    }
+#endif
+    overdrawTotal.redundantWrites += overdrawFrame.redundantWrites;
+    if(overdrawFrame.maxWrites > overdrawTotal.maxWrites) {
+        overdrawTotal.maxWrites = overdrawFrame.maxWrites;
+    }
+    ++overdrawFrames;
+
+    for(i = 0; i < OVERDRAW_PIXELS; ++i) {
+        overdrawCount[i] = 0;
+    }
+}
+
+void Overdraw_reset() {
+    uint32_t i = 0;
+    for(; i < OVERDRAW_PIXELS; ++i) {
+        overdrawCount[i] = 0;
+#ifdef HOST_BUILD
+        overdrawWorstCount[i] = 0;
+#endif
+    }
+    clearStats(&overdrawFrame);
+    clearStats(&overdrawTotal);
+    overdrawFrames = 0;
+#ifdef HOST_BUILD
+    worstRedundantWrites = 0;
+#endif
+}
+
+void Overdraw_report() {
+    if(!overdrawFrames) {
+        return;
+    }
+#ifdef HOST_BUILD
+    uint8_t bin = 0;
+    for(; bin < OVERDRAW_HISTOGRAM_BINS; ++bin) {
+        if(!overdrawTotal.histogram[bin]) {
+            continue;
+        }
+        printf("%-16s pixels per frame %.1f\n", BIN_NAMES[bin],
+            (double)overdrawTotal.histogram[bin] / overdrawFrames);
+    }
+    printf("%-16s per frame %.1f, %.1f redundant, max %u per pixel\n",
+        "overdraw writes", (double)overdrawTotal.writes / overdrawFrames,
+        (double)overdrawTotal.redundantWrites / overdrawFrames,
+        overdrawTotal.maxWrites);
+#else
+    // Totals only, the averages are the totals over the frame count
+    uint8_t bin = 0;
+    for(; bin < OVERDRAW_HISTOGRAM_BINS; ++bin) {
+        LOG_INFO_VALUE(BIN_NAMES[bin], overdrawTotal.histogram[bin]);
+        LOG_FLUSH();
+    }
+    LOG_INFO_VALUE("overdraw writes", overdrawTotal.writes);
+    LOG_INFO_VALUE("redundant writes", overdrawTotal.redundantWrites);
+    LOG_INFO_VALUE("max writes", overdrawTotal.maxWrites);
+    LOG_INFO_VALUE("overdraw frames", overdrawFrames);
+    LOG_FLUSH();
+#endif
+}
+
+#ifdef HOST_BUILD
+uint8_t Overdraw_writeImage(const char* path, const uint8_t* counts) {
+    FILE* file = fopen(path, "wb");
+    if(!file) {
+        return 0;
+    }
+    fprintf(file, "P6\n%u %u\n255\n", LCD_SCREEN_WIDTH, LCD_SCREEN_HEIGHT);
+    uint32_t i = 0;
+    for(; i < OVERDRAW_PIXELS; ++i) {
+        uint8_t bin = counts[i] < OVERDRAW_HISTOGRAM_BINS - 1 ? counts[i] :
+            OVERDRAW_HISTOGRAM_BINS - 1;
+        fwrite(BIN_COLORS[bin], 1, 3, file);
+    }
+    return fclose(file) == 0;
+}
+#endif
+
+#endif
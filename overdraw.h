@@ -0,0 +1,83 @@
+/*
+ * overdraw.h
+ *
+ *  Created on: Dec 21, 2016
+ *      Author: boer8364
+ */
+
+#ifndef OVERDRAW_H_
+#define OVERDRAW_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+#include "lcdDriver.h"
+
+/* Overdraw instrumentation, a write counter per pixel of pixelBuffer that
+ * every primitive bumps through WRITE_PIXEL. When a frame is sent the
+ * counters are summarized into a histogram of how many times each pixel was
+ * written (the clear is not counted), every write after the first one to a
+ * pixel is redundant. The host build keeps the map of the frame with the most
+ * redundant writes and can save it as an image, the target only keeps the
+ * histograms, which are cheap to read out or log */
+
+// Histogram bins, pixels written 0 to 7 times, the last bin is 8 or more
+#define OVERDRAW_HISTOGRAM_BINS 9
+
+typedef struct OverdrawStats {
+    // Number of pixels by the number of times they were written
+    uint32_t histogram[OVERDRAW_HISTOGRAM_BINS];
+    // Pixel writes, and the ones that went to an already written pixel
+    uint32_t writes;
+    uint32_t redundantWrites;
+    // Most writes to a single pixel
+    uint32_t maxWrites;
+} OverdrawStats_t;
+
+#ifdef OVERDRAW_DEBUG
+
+// Writes to each pixel in the frame in progress, saturating at 255
+extern uint8_t overdrawCount[LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT];
+// Statistics of the last sent frame
+extern OverdrawStats_t overdrawFrame;
+// Statistics summed over every frame since the last reset
+extern OverdrawStats_t overdrawTotal;
+// Number of frames in overdrawTotal
+extern uint32_t overdrawFrames;
+
+#ifdef HOST_BUILD
+// Map of the frame with the most redundant writes since the last reset
+extern uint8_t overdrawWorstCount[LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT];
+
+/* Saves a map of write counts as a binary PPM, colored from black (not
+ * written) through blue, green, yellow and red to white (8 or more), returns
+ * 0 if the file could not be written */
+uint8_t Overdraw_writeImage(const char* path, const uint8_t* counts);
+#endif
+
+/* Ends a frame, called when the buffer is sent, summarizes the counts into
+ * overdrawFrame and the total and clears them for the next frame */
+void Overdraw_endFrame();
+// Clears the counts and the statistics
+void Overdraw_reset();
+/* Reports the summed histogram, through the logger on the target and to
+ * stdout, with the per-frame averages, on the host */
+void Overdraw_report();
+
+#define COUNT_OVERDRAW(x, y) do { \
+        uint8_t* count = &overdrawCount[(y) * LCD_SCREEN_WIDTH + (x)]; \
+        if(*count != UINT8_MAX) { \
+            ++*count; \
+        } \
+    } while(0)
+#define OVERDRAW_END_FRAME() Overdraw_endFrame()
+#define OVERDRAW_RESET() Overdraw_reset()
+#define OVERDRAW_REPORT() Overdraw_report()
+#else
+// Compiled out, none of these generate any code
+#define COUNT_OVERDRAW(x, y) ((void)0)
+#define OVERDRAW_END_FRAME() ((void)0)
+#define OVERDRAW_RESET() ((void)0)
+#define OVERDRAW_REPORT() ((void)0)
+#endif
+
+#endif /* OVERDRAW_H_ */
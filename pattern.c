@@ -0,0 +1,199 @@
+/*
+ * pattern.c
+ *
+ *  Created on: Dec 13, 2016
+ *      Author: boer8364
+ */
+
+#include "pattern.h"
+
+const uint8_t PATTERN_OPERAND_COUNT[PATTERN_NUM_OPS] = {
+    0, // PATTERN_OP_END
+    1, // PATTERN_OP_WALL
+    2, // PATTERN_OP_WALL2
+    0, // PATTERN_OP_RANDOM
+    3, // PATTERN_OP_SPIRAL
+    3, // PATTERN_OP_ALTERNATE
+    1, // PATTERN_OP_WAIT
+    1, // PATTERN_OP_SPACING
+    2  // PATTERN_OP_BURST
+};
+
+// Random gaps at the difficulty spawn period, the original game
+static const uint8_t PATTERN_CLASSIC[] = {
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_END
+};
+
+// A gap that winds counter-clockwise, then back
+static const uint8_t PATTERN_SPIRAL[] = {
+    PATTERN_OP_SPIRAL, 0, 4, 4,
+    PATTERN_OP_SPIRAL, 12, 28, 4,
+    PATTERN_OP_END
+};
+
+// Gaps on opposite sides of the screen
+static const uint8_t PATTERN_ALTERNATE[] = {
+    PATTERN_OP_ALTERNATE, 8, 24, 4,
+    PATTERN_OP_END
+};
+
+// Rings with two gaps
+static const uint8_t PATTERN_DOUBLE_GAP[] = {
+    PATTERN_OP_WALL2, 0, 16,
+    PATTERN_OP_WALL2, 8, 24,
+    PATTERN_OP_WALL2, 4, 20,
+    PATTERN_OP_END
+};
+
+// A breather, then three walls in quick succession
+static const uint8_t PATTERN_BURST[] = {
+    PATTERN_OP_WAIT, 30,
+    PATTERN_OP_BURST, 3, 20,
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_WAIT, 30,
+    PATTERN_OP_END
+};
+
+// Slow walls, then the pace picks back up
+static const uint8_t PATTERN_SLOWDOWN[] = {
+    PATTERN_OP_SPACING, 60,
+    PATTERN_OP_WALL, 0,
+    PATTERN_OP_WALL, 16,
+    PATTERN_OP_SPACING, 0,
+    PATTERN_OP_RANDOM,
+    PATTERN_OP_END
+};
+
+const uint8_t* const PATTERN_LIBRARY[] = {
+    PATTERN_CLASSIC,
+    PATTERN_SPIRAL,
+    PATTERN_ALTERNATE,
+    PATTERN_DOUBLE_GAP,
+    PATTERN_BURST,
+    PATTERN_SLOWDOWN
+};
+
+const uint8_t PATTERN_LIBRARY_SIZE =
+    sizeof(PATTERN_LIBRARY) / sizeof(PATTERN_LIBRARY[0]);
+
+void Pattern_start(PatternEngine_t* self, Prng_t* prng, uint8_t initialDelay) {
+    self->prng = prng;
+    self->pc = PATTERN_LIBRARY[0];
+    self->delay = initialDelay;
+    self->spacing = 0;
+    self->burstRemaining = 0;
+    self->burstSpacing = 0;
+    self->runRemaining = 0;
+    self->runOp = PATTERN_OP_END;
+    self->runGap = 0;
+    self->runOther = 0;
+}
+
+// Returns the time until the next wall
+static uint8_t nextWallDelay(PatternEngine_t* self, uint8_t spawnPeriod) {
+    if(self->burstRemaining) {
+        --self->burstRemaining;
+        return self->burstSpacing;
+    }
+    return self->spacing ? self->spacing : spawnPeriod;
+}
+
+// Moves on to a randomly picked pattern
+static void nextPattern(PatternEngine_t* self) {
+    self->pc = PATTERN_LIBRARY[Prng_nextBounded(self->prng,
+        PATTERN_LIBRARY_SIZE)];
+    self->runRemaining = 0;
+}
+
+uint8_t Pattern_tick(PatternEngine_t* self, uint8_t spawnPeriod,
+    PatternWall_t* wall) {
+    // Count down to the next opcode
+    if(self->delay) {
+        --self->delay;
+        if(self->delay) {
+            return 0;
+        }
+    }
+
+    uint8_t opsRun;
+    for(opsRun = 0; opsRun < PATTERN_MAX_OPS_PER_TICK; ++opsRun) {
+        // Continue a spiral or alternating run before the next opcode
+        if(self->runRemaining) {
+            --self->runRemaining;
+            wall->numGaps = 1;
+            wall->gap[0] = self->runGap;
+
+            if(self->runOp == PATTERN_OP_SPIRAL) {
+                self->runGap = (self->runGap + self->runOther) %
+                    WALL_ANGLE_GENERATION_RESOLUTION;
+            } else {
+                uint8_t otherGap = self->runOther;
+                self->runOther = self->runGap;
+                self->runGap = otherGap;
+            }
+
+            self->delay = nextWallDelay(self, spawnPeriod);
+            return 1;
+        }
+
+        const uint8_t* operands = self->pc + 1;
+        uint8_t op = *self->pc;
+        if(op >= PATTERN_NUM_OPS) {
+            // Do not run off into the weeds on a bad opcode
+            nextPattern(self);
+            continue;
+        }
+        self->pc = operands + PATTERN_OPERAND_COUNT[op];
+
+        switch(op) {
+        case PATTERN_OP_END:
+            nextPattern(self);
+            break;
+        case PATTERN_OP_WALL:
+            wall->numGaps = 1;
+            wall->gap[0] = operands[0];
+            self->delay = nextWallDelay(self, spawnPeriod);
+            return 1;
+        case PATTERN_OP_WALL2:
+            wall->numGaps = 2;
+            wall->gap[0] = operands[0];
+            wall->gap[1] = operands[1];
+            self->delay = nextWallDelay(self, spawnPeriod);
+            return 1;
+        case PATTERN_OP_RANDOM:
+            wall->numGaps = 1;
+            wall->gap[0] = (uint8_t)Prng_nextBounded(self->prng,
+                WALL_ANGLE_GENERATION_RESOLUTION);
+            self->delay = nextWallDelay(self, spawnPeriod);
+            return 1;
+        case PATTERN_OP_SPIRAL:
+        case PATTERN_OP_ALTERNATE:
+            self->runOp = op;
+            self->runGap = operands[0];
+            self->runOther = operands[1];
+            self->runRemaining = operands[2];
+            break;
+        case PATTERN_OP_WAIT:
+            self->delay = operands[0];
+            if(self->delay) {
+                return 0;
+            }
+            break;
+        case PATTERN_OP_SPACING:
+            self->spacing = operands[0];
+            break;
+        case PATTERN_OP_BURST:
+            self->burstRemaining = operands[0];
+            self->burstSpacing = operands[1];
+            break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * pattern.h
+ *
+ *  Created on: Dec 13, 2016
+ *      Author: boer8364
+ */
+
+#ifndef PATTERN_H_
+#define PATTERN_H_
+
+#include <inttypes.h>
+#include "prng.h"
+#include "wall.h"
+
+/* Wall wave patterns are stored in flash as bytecode: each opcode is followed
+ * by its operand bytes, gap operands are positions in the interval
+ * [0, WALL_ANGLE_GENERATION_RESOLUTION), and times are in simulation ticks */
+// Ends the pattern, the engine moves on to another one (no operands)
+#define PATTERN_OP_END 0x00
+// Spawns a wall with one gap (gap)
+#define PATTERN_OP_WALL 0x01
+// Spawns a wall with two gaps (gap, gap)
+#define PATTERN_OP_WALL2 0x02
+// Spawns a wall with one randomly placed gap (no operands)
+#define PATTERN_OP_RANDOM 0x03
+/* Spawns count walls whose gap moves by step every wall, a step above
+ * WALL_ANGLE_GENERATION_RESOLUTION / 2 turns the other way (gap, step, count) */
+#define PATTERN_OP_SPIRAL 0x04
+// Spawns count walls alternating between two gaps (gap, gap, count)
+#define PATTERN_OP_ALTERNATE 0x05
+// Waits before running the next opcode (ticks)
+#define PATTERN_OP_WAIT 0x06
+/* Sets the time between walls, 0 goes back to the difficulty spawn period
+ * (ticks) */
+#define PATTERN_OP_SPACING 0x07
+// The next count walls are spawned close together (count, ticks)
+#define PATTERN_OP_BURST 0x08
+// Number of opcodes
+#define PATTERN_NUM_OPS 9
+
+/* Upper bound on the opcodes run in a single tick, this keeps a pattern that
+ * never spawns or waits from hanging the game loop */
+#define PATTERN_MAX_OPS_PER_TICK 8
+
+// Number of operand bytes following each opcode
+extern const uint8_t PATTERN_OPERAND_COUNT[PATTERN_NUM_OPS];
+
+// Patterns the engine picks from, stored in flash
+extern const uint8_t* const PATTERN_LIBRARY[];
+// Number of patterns in the library
+extern const uint8_t PATTERN_LIBRARY_SIZE;
+
+// A wall spawned by the engine
+typedef struct PatternWall {
+    uint8_t numGaps;
+    // Gap positions in the interval [0, WALL_ANGLE_GENERATION_RESOLUTION)
+    uint8_t gap[WALL_MAX_GAPS];
+} PatternWall_t;
+
+// State of the pattern interpreter
+typedef struct PatternEngine {
+    // Random number generator used for random gaps and picking patterns
+    Prng_t* prng;
+    // Next opcode to run
+    const uint8_t* pc;
+    // Ticks until the next opcode runs
+    uint8_t delay;
+    // Time between walls, 0 means the difficulty spawn period
+    uint8_t spacing;
+    // Walls left in the current burst and the time between them
+    uint8_t burstRemaining;
+    uint8_t burstSpacing;
+    // Walls left in the current spiral or alternating run
+    uint8_t runRemaining;
+    // Opcode of the current run
+    uint8_t runOp;
+    // Gap of the next wall in the run
+    uint8_t runGap;
+    // Step of a spiral or the other gap of an alternating run
+    uint8_t runOther;
+} PatternEngine_t;
+
+/* Starts the engine on the first pattern of the library, the first opcode
+ * runs after initialDelay ticks */
+void Pattern_start(PatternEngine_t* self, Prng_t* prng, uint8_t initialDelay);
+
+/* Advances the engine by one simulation tick, spawnPeriod is the current
+ * difficulty's time between walls, returns 1 and fills in wall if a wall
+ * spawns on this tick */
+uint8_t Pattern_tick(PatternEngine_t* self, uint8_t spawnPeriod,
+    PatternWall_t* wall);
+
+#endif /* PATTERN_H_ */
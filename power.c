@@ -0,0 +1,48 @@
+/*
+ * power.c
+ *
+ *  Created on: Dec 10, 2016
+ *      Author: boer8364
+ */
+
+#include "power.h"
+#include "hal.h"
+#include "simClock.h"
+
+PowerStats_t powerStats;
+volatile PowerState_t powerState = POWER_STATE_ACTIVE;
+
+// Timestamp of the last accounting reset
+static uint32_t statsStartTime = 0;
+
+void Power_sleep(PowerMode_t mode) {
+    uint32_t sleepStart = SimClock_now();
+
+    // Update the state and count the entry
+    if(mode == POWER_MODE_LPM3) {
+        powerState = POWER_STATE_LPM3;
+        ++powerStats.lpm3Entries;
+    } else {
+        powerState = POWER_STATE_LPM0;
+        ++powerStats.lpm0Entries;
+    }
+
+    Hal_waitForInterrupt(mode == POWER_MODE_LPM3);
+
+    powerState = POWER_STATE_ACTIVE;
+
+    /* The simulation clock keeps counting in LPM0, it is stopped in LPM3 so
+     * those sleeps only show up in the entry count */
+    powerStats.sleepTime += SimClock_now() - sleepStart;
+}
+
+void Power_resetStats() {
+    powerStats.sleepTime = 0;
+    powerStats.lpm0Entries = 0;
+    powerStats.lpm3Entries = 0;
+    statsStartTime = SimClock_now();
+}
+
+uint32_t Power_getActiveTime() {
+    return SimClock_now() - statsStartTime - powerStats.sleepTime;
+}
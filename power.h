@@ -0,0 +1,78 @@
+/*
+ * power.h
+ *
+ *  Created on: Dec 10, 2016
+ *      Author: boer8364
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+// Low-power modes the CPU can idle in
+typedef enum PowerMode {
+    /* CPU clock stopped, all peripheral clocks keep running, any interrupt
+     * (timers, ADC, SPI, button) wakes the CPU */
+    POWER_MODE_LPM0 = 0,
+    /* Deep sleep, only the button and the RTC/WDT can wake the CPU, the
+     * ACLK timers (and so the simulation clock) are stopped */
+    POWER_MODE_LPM3 = 1
+} PowerMode_t;
+
+// States of the idle layer
+typedef enum PowerState {
+    POWER_STATE_ACTIVE = 0,
+    POWER_STATE_LPM0 = 1,
+    POWER_STATE_LPM3 = 2
+} PowerState_t;
+
+// Mode used while waiting on the title and game over screens
+#define POWER_IDLE_MODE POWER_MODE_LPM3
+/* Mode used while waiting on the title screen, the simulation clock has to
+ * keep counting there since the time until the button press seeds the walls */
+#define POWER_TITLE_MODE POWER_MODE_LPM0
+
+/* Frame pacing flag, when enabled the game loop sleeps in LPM0 for the rest
+ * of the frame budget instead of spinning until the next simulation tick */
+#define POWER_FRAME_PACING
+
+// Active versus sleep time accounting
+typedef struct PowerStats {
+    // Time spent asleep in simulation clock (ACLK) cycles
+    uint32_t sleepTime;
+    // Number of times the CPU went to sleep in each mode
+    uint32_t lpm0Entries;
+    uint32_t lpm3Entries;
+} PowerStats_t;
+
+// Global instance of the accounting
+extern PowerStats_t powerStats;
+// Current state of the idle layer
+extern volatile PowerState_t powerState;
+
+/* Puts the CPU to sleep in the given mode until the next interrupt, it must
+ * be called with interrupts disabled, the interrupt that wakes the CPU up is
+ * serviced once interrupts are re-enabled */
+void Power_sleep(PowerMode_t mode);
+
+// Resets the accounting, the active time is counted from this point on
+void Power_resetStats();
+// Returns the time spent awake since the last reset in ACLK cycles
+uint32_t Power_getActiveTime();
+
+/* Sleeps in the given mode for as long as condition holds, the condition is
+ * checked with interrupts disabled so that an interrupt which changes it can
+ * not slip in between the check and the sleep */
+#define POWER_SLEEP_WHILE(condition, mode) do { \
+        DISABLE_INTERRUPTS(); \
+        while(condition) { \
+            Power_sleep(mode); \
+            ENABLE_INTERRUPTS(); \
+            DISABLE_INTERRUPTS(); \
+        } \
+        ENABLE_INTERRUPTS(); \
+    } while(0)
+
+#endif /* POWER_H_ */
@@ -0,0 +1,42 @@
+/*
+ * prng.c
+ *
+ *  Created on: Dec 12, 2016
+ *      Author: boer8364
+ */
+
+#include "prng.h"
+
+// Substitute state, xorshift gets stuck at 0 forever
+#define PRNG_ZERO_SEED_REPLACEMENT 0x9e3779b9
+
+void Prng_seed(Prng_t* self, uint32_t seed) {
+    /* Mix the seed with a splitmix32 step first, xorshift takes a few rounds
+     * to carry the bits of a small seed up, so the first numbers would have
+     * small high bits and Prng_nextBounded would keep returning 0 */
+    uint32_t z = seed + 0x9e3779b9;
+    z = (z ^ (z >> 16)) * 0x85ebca6b;
+    z = (z ^ (z >> 13)) * 0xc2b2ae35;
+    z ^= z >> 16;
+    self->state = z ? z : PRNG_ZERO_SEED_REPLACEMENT;
+}
+
+uint32_t Prng_nextBounded(Prng_t* self, uint32_t bound) {
+    /* Scale the 32-bit number into the interval with a widening multiply, the
+     * result is the upper half, this uses the better high bits of xorshift
+     * and avoids a division in the common case */
+    uint64_t product = (uint64_t)Prng_next(self) * bound;
+    uint32_t low = (uint32_t)product;
+
+    /* The lower half tells if this number falls in the few values that would
+     * make the result biased, if so draw again (rare unless bound is huge) */
+    if(low < bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while(low < threshold) {
+            product = (uint64_t)Prng_next(self) * bound;
+            low = (uint32_t)product;
+        }
+    }
+
+    return (uint32_t)(product >> 32);
+}
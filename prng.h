@@ -0,0 +1,39 @@
+/*
+ * prng.h
+ *
+ *  Created on: Dec 12, 2016
+ *      Author: boer8364
+ */
+
+#ifndef PRNG_H_
+#define PRNG_H_
+
+#include <inttypes.h>
+
+/* xorshift32 pseudo-random number generator, the whole state is explicit so
+ * the same seed gives the same sequence on every toolchain, and separate
+ * generators never interfere with each other */
+typedef struct Prng {
+    // Current state, never 0
+    uint32_t state;
+} Prng_t;
+
+/* Seeds the generator, any seed is allowed, nearby seeds such as successive
+ * clock readings give unrelated sequences */
+void Prng_seed(Prng_t* self, uint32_t seed);
+
+// Returns the next 32-bit pseudo-random number
+static inline uint32_t Prng_next(Prng_t* self) {
+    uint32_t x = self->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    self->state = x;
+    return x;
+}
+
+/* Returns a pseudo-random number uniformly distributed in the interval
+ * [0, bound), bound must not be 0 */
+uint32_t Prng_nextBounded(Prng_t* self, uint32_t bound);
+
+#endif /* PRNG_H_ */
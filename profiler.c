@@ -0,0 +1,209 @@
+/*
+ * profiler.c
+ *
+ *  Created on: Dec 17, 2016
+ *      Author: boer8364
+ */
+
+#include "profiler.h"
+#include "simClock.h"
+
+#ifdef PROFILE_DEBUG
+
+#ifdef HOST_BUILD
+#include <stdio.h>
+
+// Count leading zeros, 0 is not a valid input
+#define COUNT_LEADING_ZEROS(x) __builtin_clz(x)
+#else
+#include "uartLogger.h"
+
+#define COUNT_LEADING_ZEROS(x) __CLZ(x)
+#endif
+
+ProfileZoneStats_t profileStats[PROFILE_ZONE_COUNT];
+uint32_t profileZoneStart[PROFILE_ZONE_COUNT];
+ProfileClockStats_t profileClockStats[CLOCK_PROFILE_COUNT];
+
+// Time the current clock profile was switched to, or the stats were reset
+static uint32_t clockProfileStart;
+
+static const char* const ZONE_NAMES[PROFILE_ZONE_COUNT] = {
+    "frame",
+    "input",
+    "collision",
+    "wall update",
+    "draw boundary",
+    "draw walls",
+    "draw player",
+    "clear",
+    "spi send",
+    "isr sim timer",
+    "isr button",
+    "isr uart"
+};
+
+void Profile_init() {
+    Hal_cycleCounterInit();
+    Profile_reset();
+}
+
+void Profile_reset() {
+    uint8_t zone = 0;
+    for(; zone < PROFILE_ZONE_COUNT; ++zone) {
+        ProfileZoneStats_t* stats = &profileStats[zone];
+        stats->count = 0;
+        stats->min = UINT32_MAX;
+        stats->max = 0;
+        stats->total = 0;
+        uint8_t bin = 0;
+        for(; bin < PROFILE_HISTOGRAM_BINS; ++bin) {
+            stats->histogram[bin] = 0;
+        }
+    }
+    uint8_t profile = 0;
+    for(; profile < CLOCK_PROFILE_COUNT; ++profile) {
+        profileClockStats[profile].frames = 0;
+        profileClockStats[profile].time = 0;
+    }
+    clockProfileStart = SimClock_now();
+}
+
+void Profile_record(ProfileZone_t zone, uint32_t ticks) {
+    ProfileZoneStats_t* stats = &profileStats[zone];
+    ++stats->count;
+    stats->total += ticks;
+    if(ticks < stats->min) {
+        stats->min = ticks;
+    }
+    if(ticks > stats->max) {
+        stats->max = ticks;
+    }
+
+    // The bin is the position of the highest set bit
+    uint8_t bin = ticks ? 31 - COUNT_LEADING_ZEROS(ticks) : 0;
+    if(bin >= PROFILE_HISTOGRAM_BINS) {
+        bin = PROFILE_HISTOGRAM_BINS - 1;
+    }
+    // Saturate rather than wrap around
+    if(stats->histogram[bin] != UINT16_MAX) {
+        ++stats->histogram[bin];
+    }
+
+    if(zone == PROFILE_ZONE_FRAME) {
+        ++profileClockStats[clockProfile].frames;
+    }
+}
+
+void Profile_clockChanged(ClockProfileId_t previous) {
+    uint32_t now = SimClock_now();
+    profileClockStats[previous].time += now - clockProfileStart;
+    clockProfileStart = now;
+}
+
+void Profile_firstFrame(uint32_t bootStart, uint32_t panelWait) {
+    uint32_t firstFrame = HAL_CYCLES_TO_US(PROFILE_NOW() - bootStart);
+    panelWait = HAL_CYCLES_TO_US(panelWait);
+
+#ifdef HOST_BUILD
+    printf("first frame us %u panel wait us %u\n", firstFrame, panelWait);
+#elif defined(UART_DEBUG)
+    UART_Logger_sendString("first frame us ");
+    UART_Logger_sendNumSigned((int32_t)firstFrame);
+    UART_Logger_sendString(" panel wait us ");
+    UART_Logger_sendNumSigned((int32_t)panelWait);
+    UART_Logger_sendByte((uint8_t)'\r');
+#else
+    (void)firstFrame;
+#endif
+}
+
+// Reports the frame rate of every clock profile that ran frames
+static void reportClockProfiles() {
+    uint8_t profile = 0;
+    for(; profile < CLOCK_PROFILE_COUNT; ++profile) {
+        ProfileClockStats_t* stats = &profileClockStats[profile];
+        if(!stats->frames || !stats->time) {
+            continue;
+        }
+        uint32_t milliseconds =
+            (uint32_t)((uint64_t)stats->time * 1000 / SIM_CLOCK_FREQUENCY);
+        uint32_t fps = (uint32_t)((uint64_t)stats->frames *
+            SIM_CLOCK_FREQUENCY / stats->time);
+
+#ifdef HOST_BUILD
+        printf("clock %-8s frames %u ms %u fps %u\n",
+            clockProfiles[profile].name, stats->frames, milliseconds, fps);
+#elif defined(UART_DEBUG)
+        UART_Logger_sendString("clock ");
+        UART_Logger_sendString(clockProfiles[profile].name);
+        UART_Logger_sendString(" frames ");
+        UART_Logger_sendNumSigned((int32_t)stats->frames);
+        UART_Logger_sendString(" ms ");
+        UART_Logger_sendNumSigned((int32_t)milliseconds);
+        UART_Logger_sendString(" fps ");
+        UART_Logger_sendNumSigned((int32_t)fps);
+        UART_Logger_sendByte((uint8_t)'\r');
+        UART_Logger_flush();
+#else
+        (void)milliseconds;
+        (void)fps;
+#endif
+    }
+}
+
+void Profile_report() {
+    /* Count the current profile up to now, the time spent waiting for the
+     * report to go out does not count */
+    Profile_clockChanged(clockProfile);
+    uint8_t zone = 0;
+    for(; zone < PROFILE_ZONE_COUNT; ++zone) {
+        ProfileZoneStats_t* stats = &profileStats[zone];
+        if(!stats->count) {
+            continue;
+        }
+        uint32_t average = (uint32_t)(stats->total / stats->count);
+
+#ifdef HOST_BUILD
+        printf("%-14s n %u min %u avg %u max %u |", ZONE_NAMES[zone],
+            stats->count, stats->min, average, stats->max);
+        uint8_t bin = 0;
+        for(; bin < PROFILE_HISTOGRAM_BINS; ++bin) {
+            if(stats->histogram[bin]) {
+                printf(" 2^%u:%u", bin, stats->histogram[bin]);
+            }
+        }
+        printf("\n");
+#elif defined(UART_DEBUG)
+        UART_Logger_sendString(ZONE_NAMES[zone]);
+        UART_Logger_sendString(" n ");
+        UART_Logger_sendNumSigned((int32_t)stats->count);
+        UART_Logger_sendString(" min ");
+        UART_Logger_sendNumSigned((int32_t)stats->min);
+        UART_Logger_sendString(" avg ");
+        UART_Logger_sendNumSigned((int32_t)average);
+        UART_Logger_sendString(" max ");
+        UART_Logger_sendNumSigned((int32_t)stats->max);
+        UART_Logger_sendString(" |");
+        uint8_t bin = 0;
+        for(; bin < PROFILE_HISTOGRAM_BINS; ++bin) {
+            if(stats->histogram[bin]) {
+                UART_Logger_sendString(" 2^");
+                UART_Logger_sendNumSigned(bin);
+                UART_Logger_sendByte((uint8_t)':');
+                UART_Logger_sendNumSigned(stats->histogram[bin]);
+            }
+        }
+        UART_Logger_sendByte((uint8_t)'\r');
+        // A line fits in the buffer, the whole report does not
+        UART_Logger_flush();
+#else
+        /* Without a UART the statistics can still be read out of
+         * profileStats with the debugger */
+        (void)average;
+#endif
+    }
+    reportClockProfiles();
+}
+
+#endif
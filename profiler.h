@@ -0,0 +1,116 @@
+/*
+ * profiler.h
+ *
+ *  Created on: Dec 17, 2016
+ *      Author: boer8364
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+#include "hal.h"
+#include "clock.h"
+
+/* Zones are timed with the DWT cycle counter on the target and with the
+ * monotonic clock in nanoseconds on the host, the report calls both units
+ * "ticks". A zone must not be nested inside itself */
+typedef enum ProfileZone {
+    // Whole game loop iteration
+    PROFILE_ZONE_FRAME = 0,
+    // Accelerometer read and input mapping
+    PROFILE_ZONE_INPUT,
+    // Collision checks and responses against the walls and the boundary
+    PROFILE_ZONE_COLLISION,
+    // Pattern engine, wall spawning and closing the walls in
+    PROFILE_ZONE_WALL_UPDATE,
+    // Draw calls
+    PROFILE_ZONE_DRAW_BOUNDARY,
+    PROFILE_ZONE_DRAW_WALLS,
+    PROFILE_ZONE_DRAW_PLAYER,
+    // Clearing the frame buffer on its own
+    PROFILE_ZONE_CLEAR,
+    /* Sending the frame buffer over SPI, LCD_sendAndClearBuffer clears in the
+     * same loop so its clear is counted here */
+    PROFILE_ZONE_SPI_SEND,
+    // ISRs
+    PROFILE_ZONE_ISR_SIM_TIMER,
+    PROFILE_ZONE_ISR_BUTTON,
+    PROFILE_ZONE_ISR_UART,
+    // Number of zones, not a zone
+    PROFILE_ZONE_COUNT
+} ProfileZone_t;
+
+/* Number of histogram bins, bin i counts the samples that took
+ * [2^i, 2^(i + 1)) ticks, the last bin also takes everything longer */
+#define PROFILE_HISTOGRAM_BINS 24
+
+// Statistics of a zone
+typedef struct ProfileZoneStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint16_t histogram[PROFILE_HISTOGRAM_BINS];
+} ProfileZoneStats_t;
+
+/* Frame rate of a clock profile, the time is taken from the simulation clock
+ * so that it means the same in every profile */
+typedef struct ProfileClockStats {
+    // Game loop iterations timed while the profile was on
+    uint32_t frames;
+    // Time spent in the profile in simulation clock (ACLK) cycles
+    uint32_t time;
+} ProfileClockStats_t;
+
+#ifdef PROFILE_DEBUG
+
+// Statistics of every zone
+extern ProfileZoneStats_t profileStats[PROFILE_ZONE_COUNT];
+// Time each zone was last entered
+extern uint32_t profileZoneStart[PROFILE_ZONE_COUNT];
+// Frame rate accounting of every clock profile
+extern ProfileClockStats_t profileClockStats[CLOCK_PROFILE_COUNT];
+
+#define PROFILE_NOW() Hal_cycleCount()
+
+// Starts the cycle counter and clears the statistics
+void Profile_init();
+// Clears the statistics
+void Profile_reset();
+// Adds a sample to a zone
+void Profile_record(ProfileZone_t zone, uint32_t ticks);
+/* Closes the time the previous profile was on, Clock_setProfile calls it
+ * after every switch */
+void Profile_clockChanged(ClockProfileId_t previous);
+/* Reports the time from bootStart to the first frame on the panel and how
+ * much of it was spent waiting for the panel to wake up, in microseconds */
+void Profile_firstFrame(uint32_t bootStart, uint32_t panelWait);
+/* Dumps the statistics of every zone that has samples and the frame rate of
+ * every profile that ran frames, over the UART on the target (when UART_DEBUG
+ * is on) and to stdout on the host */
+void Profile_report();
+
+#define PROFILE_BEGIN(zone) (profileZoneStart[(zone)] = PROFILE_NOW())
+#define PROFILE_END(zone) \
+    Profile_record((zone), PROFILE_NOW() - profileZoneStart[(zone)])
+#define PROFILE_INIT() Profile_init()
+#define PROFILE_RESET() Profile_reset()
+#define PROFILE_REPORT() Profile_report()
+#define PROFILE_CLOCK_CHANGED(previous) Profile_clockChanged(previous)
+#define PROFILE_FIRST_FRAME(bootStart, panelWait) \
+    Profile_firstFrame((bootStart), (panelWait))
+#else
+// Compiled out, none of these generate any code
+#define PROFILE_BEGIN(zone) ((void)0)
+#define PROFILE_END(zone) ((void)0)
+#define PROFILE_INIT() ((void)0)
+#define PROFILE_RESET() ((void)0)
+#define PROFILE_REPORT() ((void)0)
+#define PROFILE_CLOCK_CHANGED(previous) ((void)(previous))
+#define PROFILE_FIRST_FRAME(bootStart, panelWait) \
+    ((void)(bootStart), (void)(panelWait))
+#endif
+
+#endif /* PROFILER_H_ */
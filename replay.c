@@ -0,0 +1,279 @@
+/*
+ * replay.c
+ *
+ *  Created on: Dec 19, 2016
+ *      Author: boer8364
+ */
+
+#include "replay.h"
+
+#ifdef INPUT_REPLAY
+
+ReplayMode_t replayMode = REPLAY_MODE_OFF;
+ReplayStats_t replayStats;
+uint8_t replayBuffer[REPLAY_BUFFER_SIZE] MEMORY_SECTION(".debugbuffers");
+uint32_t replayLength = 0;
+
+// Stream being played back and the read position in it
+static const uint8_t* playbackStream;
+static uint32_t playbackLength;
+static uint32_t playbackPosition;
+
+// Previous reading, the readings are delta encoded against it
+static AccelerometerReading_t previousReading;
+// Ticks left in the current repeat record
+static uint8_t repeatTicks;
+// Ticks of the current game
+static uint32_t gameTicks;
+// Position of the current repeat record while recording, 0 when there is none
+static uint32_t repeatRecord;
+
+static void resetStream() {
+    replayStats.games = 0;
+    replayStats.ticks = 0;
+    replayStats.mismatches = 0;
+    replayStats.truncated = 0;
+    previousReading.x = 0;
+    previousReading.y = 0;
+    repeatTicks = 0;
+    repeatRecord = 0;
+}
+
+/* ***** Recording ***** */
+
+/* Appends bytes to the recording and terminates it, the bytes are dropped
+ * and the recording stopped if they do not fit */
+static uint8_t write(const uint8_t* bytes, uint8_t length) {
+    if(replayStats.truncated ||
+        replayLength + length + 1 > REPLAY_BUFFER_SIZE) {
+        replayStats.truncated = 1;
+        return 0;
+    }
+    uint8_t i = 0;
+    for(; i < length; ++i) {
+        replayBuffer[replayLength++] = bytes[i];
+    }
+    replayBuffer[replayLength] = REPLAY_RECORD_END;
+    return 1;
+}
+
+// Encodes a signed value as a zigzag varint, returns the number of bytes
+static uint8_t encodeVarint(int32_t value, uint8_t* out) {
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    uint8_t length = 0;
+    while(zigzag >= 0x80) {
+        out[length++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    out[length++] = (uint8_t)zigzag;
+    return length;
+}
+
+// Stores a 32-bit operand, little endian
+static void put32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+static void recordReading(const AccelerometerReading_t* reading) {
+    if(reading->x == previousReading.x && reading->y == previousReading.y) {
+        // Extend the current repeat record if there is room left in it
+        if(repeatRecord && replayBuffer[repeatRecord + 1] < 255) {
+            ++replayBuffer[repeatRecord + 1];
+            return;
+        }
+        uint8_t record[2] = {REPLAY_RECORD_REPEAT, 1};
+        if(write(record, sizeof(record))) {
+            repeatRecord = replayLength - sizeof(record);
+        }
+        return;
+    }
+
+    uint8_t record[1 + 2 * 5];
+    uint8_t length = 0;
+    record[length++] = REPLAY_RECORD_READING;
+    length += encodeVarint(reading->x - previousReading.x, &record[length]);
+    length += encodeVarint(reading->y - previousReading.y, &record[length]);
+    write(record, length);
+    repeatRecord = 0;
+    previousReading = *reading;
+}
+
+/* ***** Playback ***** */
+
+// Returns the tag of the next record without consuming it
+static uint8_t peek() {
+    if(playbackPosition >= playbackLength) {
+        return REPLAY_RECORD_END;
+    }
+    return playbackStream[playbackPosition];
+}
+
+// Reads a byte of an operand, a stream cut short reads as zeros
+static uint8_t readByte() {
+    if(playbackPosition >= playbackLength) {
+        replayStats.truncated = 1;
+        return 0;
+    }
+    return playbackStream[playbackPosition++];
+}
+
+static uint32_t read32() {
+    uint32_t value = readByte();
+    value |= (uint32_t)readByte() << 8;
+    value |= (uint32_t)readByte() << 16;
+    value |= (uint32_t)readByte() << 24;
+    return value;
+}
+
+static int32_t decodeVarint() {
+    uint32_t zigzag = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        byte = readByte();
+        zigzag |= (uint32_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while((byte & 0x80) && shift < 32);
+    return (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+}
+
+/* Skips records up to and including the next one with the given tag, its
+ * operands are left to be read, returns 0 if the stream ends first */
+static uint8_t seek(uint8_t tag) {
+    while(peek() != tag) {
+        switch(peek()) {
+        case REPLAY_RECORD_END:
+            return 0;
+        case REPLAY_RECORD_GAME_START:
+            playbackPosition += 1 + 4;
+            break;
+        case REPLAY_RECORD_GAME_OVER:
+            playbackPosition += 1 + 8;
+            break;
+        case REPLAY_RECORD_READING:
+            ++playbackPosition;
+            decodeVarint();
+            decodeVarint();
+            break;
+        case REPLAY_RECORD_REPEAT:
+            playbackPosition += 2;
+            break;
+        case REPLAY_RECORD_BUTTON:
+            ++playbackPosition;
+            break;
+        default:
+            // Not a stream this version can decode
+            replayStats.truncated = 1;
+            playbackPosition = playbackLength;
+            return 0;
+        }
+    }
+    ++playbackPosition;
+    return 1;
+}
+
+/* ***** Hooks ***** */
+
+void Replay_startRecording() {
+    resetStream();
+    replayLength = 0;
+    replayBuffer[0] = REPLAY_RECORD_END;
+    replayMode = REPLAY_MODE_RECORD;
+}
+
+void Replay_startPlayback(const uint8_t* stream, uint32_t length) {
+    resetStream();
+    playbackStream = stream;
+    playbackLength = length;
+    playbackPosition = 0;
+    replayMode = REPLAY_MODE_PLAYBACK;
+}
+
+uint8_t Replay_finished() {
+    return replayMode == REPLAY_MODE_PLAYBACK && peek() == REPLAY_RECORD_END;
+}
+
+uint32_t Replay_seed(uint32_t liveSeed) {
+    // Every game starts the delta encoding over
+    gameTicks = 0;
+    previousReading.x = 0;
+    previousReading.y = 0;
+    repeatTicks = 0;
+    repeatRecord = 0;
+
+    if(replayMode == REPLAY_MODE_RECORD) {
+        ++replayStats.games;
+        uint8_t record[1 + 4];
+        record[0] = REPLAY_RECORD_GAME_START;
+        put32(&record[1], liveSeed);
+        write(record, sizeof(record));
+    } else if(replayMode == REPLAY_MODE_PLAYBACK &&
+        seek(REPLAY_RECORD_GAME_START)) {
+        ++replayStats.games;
+        return read32();
+    }
+    return liveSeed;
+}
+
+void Replay_reading(AccelerometerReading_t* reading) {
+    if(replayMode == REPLAY_MODE_RECORD) {
+        ++replayStats.ticks;
+        ++gameTicks;
+        recordReading(reading);
+    } else if(replayMode == REPLAY_MODE_PLAYBACK) {
+        if(!repeatTicks) {
+            if(peek() == REPLAY_RECORD_READING) {
+                ++playbackPosition;
+                previousReading.x += decodeVarint();
+                previousReading.y += decodeVarint();
+                repeatTicks = 1;
+            } else if(peek() == REPLAY_RECORD_REPEAT) {
+                ++playbackPosition;
+                repeatTicks = readByte();
+            } else {
+                /* The game outlasted the recording, hold the last reading,
+                 * the game over check counts the mismatch */
+                repeatTicks = 1;
+            }
+        }
+        --repeatTicks;
+        ++replayStats.ticks;
+        ++gameTicks;
+        *reading = previousReading;
+    }
+}
+
+uint8_t Replay_button(uint8_t livePressed) {
+    if(replayMode == REPLAY_MODE_RECORD) {
+        if(livePressed) {
+            uint8_t record = REPLAY_RECORD_BUTTON;
+            write(&record, 1);
+            repeatRecord = 0;
+        }
+    } else if(replayMode == REPLAY_MODE_PLAYBACK && !Replay_finished()) {
+        return seek(REPLAY_RECORD_BUTTON);
+    }
+    return livePressed;
+}
+
+void Replay_gameOver(uint32_t checksum) {
+    if(replayMode == REPLAY_MODE_RECORD) {
+        uint8_t record[1 + 8];
+        record[0] = REPLAY_RECORD_GAME_OVER;
+        put32(&record[1], gameTicks);
+        put32(&record[5], checksum);
+        write(record, sizeof(record));
+        repeatRecord = 0;
+    } else if(replayMode == REPLAY_MODE_PLAYBACK) {
+        // Any readings the game did not use are skipped by the seek
+        if(!seek(REPLAY_RECORD_GAME_OVER) || read32() != gameTicks ||
+            read32() != checksum) {
+            ++replayStats.mismatches;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * replay.h
+ *
+ *  Created on: Dec 19, 2016
+ *      Author: boer8364
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+#include "accelerometer.h"
+
+/* Input record and replay. Everything that makes one game play differently
+ * from another goes through here: the seed, the accelerometer reading of
+ * every simulation tick and the button presses. A recording fed back in
+ * reproduces the same walls and player movement tick for tick, which makes it
+ * a fixed workload for comparing builds.
+ *
+ * The stream is a sequence of records, each a tag byte followed by its
+ * operands. Readings are stored as the difference to the previous reading,
+ * zigzag encoded (0, -1, 1, -2...) as a varint of 7 bits per byte, so a tick
+ * whose deltas are both within -64 to 63 costs 3 bytes. A tilt that is on the
+ * move often takes a delta past that, replayTool measures about 4.4 bytes per
+ * tick on the host runs, 132 bytes per second of play */
+typedef enum ReplayRecord {
+    // End of the stream
+    REPLAY_RECORD_END = 0,
+    // Start of a game, operand: the 32-bit seed, little endian
+    REPLAY_RECORD_GAME_START = 1,
+    // Reading of one tick, operands: the x and y deltas as varints
+    REPLAY_RECORD_READING = 2,
+    // The previous reading again, operand: the number of ticks, 1 to 255
+    REPLAY_RECORD_REPEAT = 3,
+    // Button press
+    REPLAY_RECORD_BUTTON = 4,
+    /* End of a game, operands: the 32-bit number of ticks the game ran for
+     * and a 32-bit checksum of the game state, playback checks both */
+    REPLAY_RECORD_GAME_OVER = 5
+} ReplayRecord_t;
+
+typedef enum ReplayMode {
+    REPLAY_MODE_OFF = 0,
+    REPLAY_MODE_RECORD,
+    REPLAY_MODE_PLAYBACK
+} ReplayMode_t;
+
+/* Size of the recording buffer. On the target it shares the .debugbuffers
+ * budget with the overdraw counts (16K), next to them it only holds about
+ * 30 seconds of play, a longer recording is truncated. Without
+ * OVERDRAW_DEBUG it takes their place and holds about 2 minutes */
+#ifdef HOST_BUILD
+#define REPLAY_BUFFER_SIZE (1 << 20)
+#elif defined(OVERDRAW_DEBUG)
+#define REPLAY_BUFFER_SIZE 4096
+#else
+#define REPLAY_BUFFER_SIZE 16384
+#endif
+
+typedef struct ReplayStats {
+    // Games started
+    uint32_t games;
+    // Ticks recorded or played back
+    uint32_t ticks;
+    // Games whose tick count or checksum differed from the recording
+    uint32_t mismatches;
+    // Set when the recording did not fit in the buffer or could not be decoded
+    uint8_t truncated;
+} ReplayStats_t;
+
+#ifdef INPUT_REPLAY
+
+extern ReplayMode_t replayMode;
+extern ReplayStats_t replayStats;
+/* The recording, for the debugger or the host to read out, it ends with a
+ * REPLAY_RECORD_END that is overwritten by the next record */
+extern uint8_t replayBuffer[REPLAY_BUFFER_SIZE];
+// Number of bytes in the recording, not counting the end record
+extern uint32_t replayLength;
+
+// Starts recording into replayBuffer
+void Replay_startRecording();
+// Starts playing back a stream, the stream must outlive the playback
+void Replay_startPlayback(const uint8_t* stream, uint32_t length);
+// Returns 1 once a playback has consumed its whole stream
+uint8_t Replay_finished();
+
+// Returns the seed to use for a new game
+uint32_t Replay_seed(uint32_t liveSeed);
+// Records, or replaces with the recorded one, the reading of a tick
+void Replay_reading(AccelerometerReading_t* reading);
+/* Returns whether the button has been pressed, records the live press or
+ * plays back a recorded one, once a playback is finished the live button is
+ * used again */
+uint8_t Replay_button(uint8_t livePressed);
+/* Records, or checks against the recording, how long the game lasted and the
+ * state it ended in, the checksum should cover whatever state must match
+ * between runs */
+void Replay_gameOver(uint32_t checksum);
+
+#ifndef HOST_BUILD
+/* Stream built into the target image, from replayStream.c, the target plays
+ * it back when it is not empty and records otherwise */
+extern const uint8_t replayStream[];
+extern const uint32_t replayStreamLength;
+#endif
+
+#define REPLAY_SEED(liveSeed) Replay_seed(liveSeed)
+#define REPLAY_READING(reading) Replay_reading(reading)
+#define REPLAY_BUTTON(livePressed) Replay_button(livePressed)
+#define REPLAY_GAME_OVER(checksum) Replay_gameOver(checksum)
+#else
+// Compiled out, the live inputs pass straight through
+#define REPLAY_SEED(liveSeed) (liveSeed)
+#define REPLAY_READING(reading) ((void)0)
+#define REPLAY_BUTTON(livePressed) (livePressed)
+#define REPLAY_GAME_OVER(checksum) ((void)0)
+#endif
+
+#endif /* REPLAY_H_ */
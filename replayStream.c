@@ -0,0 +1,22 @@
+/*
+ * replayStream.c
+ *
+ *  Created on: Dec 19, 2016
+ *      Author: boer8364
+ */
+
+#include "globalMacros.h"
+
+#if defined(INPUT_REPLAY) && !defined(HOST_BUILD)
+
+#include "replay.h"
+
+/* Recording the target plays back, empty so that the target records. Paste
+ * in the output of tools/replayTool.c -c to build a recording into the
+ * image */
+const uint8_t replayStream[] = {
+    REPLAY_RECORD_END
+};
+const uint32_t replayStreamLength = 0;
+
+#endif
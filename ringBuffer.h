@@ -0,0 +1,227 @@
+/*
+ * ringBuffer.h
+ *
+ *  Created on: Dec 11, 2016
+ *      Author: boer8364
+ */
+
+#ifndef RINGBUFFER_H_
+#define RINGBUFFER_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+#ifndef HOST_BUILD
+// Needed for the memory barrier intrinsic
+#include "msp.h"
+#endif
+
+/* Ring buffers are statically allocated and their capacities are powers of
+ * two, the head and tail are free-running counters that are wrapped into the
+ * data array with a mask, so the item count is simply head - tail and the
+ * whole capacity can be used */
+#define RING_BUFFER_CAPACITY(capacityLog2) (1u << (capacityLog2))
+#define RING_BUFFER_MASK(capacityLog2) (RING_BUFFER_CAPACITY(capacityLog2) - 1)
+
+/* Free-running head and tail of a ring buffer, kept apart from the items so
+ * that a buffer can store its items however it likes (an array of items, or
+ * one array per field). Safe to share between one producer and one consumer
+ * (for example an ISR and the game loop) without disabling interrupts: the
+ * head is only written by the producer and the tail only by the consumer,
+ * with a memory barrier between the item accesses and the index updates */
+typedef struct RingBufferIndex {
+    // Number of items ever added, only written by the producer
+    volatile uint32_t head;
+    // Number of items ever removed, only written by the consumer
+    volatile uint32_t tail;
+} RingBufferIndex_t;
+
+static inline void RingBufferIndex_init(RingBufferIndex_t* self) {
+    self->head = 0;
+    self->tail = 0;
+}
+
+static inline uint32_t RingBufferIndex_count(RingBufferIndex_t* self) {
+    return self->head - self->tail;
+}
+
+/* Writes the free-running index of the slot the next item goes into to head,
+ * returns 0 if all capacity slots are in use (producer only) */
+static inline uint8_t RingBufferIndex_reserve(RingBufferIndex_t* self,
+    uint32_t capacity, uint32_t* head) {
+    *head = self->head;
+    return *head - self->tail < capacity;
+}
+
+/* Publishes count items written at the head, after the writes (producer
+ * only) */
+static inline void RingBufferIndex_publish(RingBufferIndex_t* self,
+    uint32_t count) {
+    MEMORY_BARRIER();
+    self->head += count;
+}
+
+/* Writes the free-running index of the oldest item to tail, returns 0 if the
+ * buffer is empty, the item may only be read after this (consumer only) */
+static inline uint8_t RingBufferIndex_acquire(RingBufferIndex_t* self,
+    uint32_t* tail) {
+    *tail = self->tail;
+    if(self->head == *tail) {
+        return 0;
+    }
+    MEMORY_BARRIER();
+    return 1;
+}
+
+/* Releases the count oldest items, after the reads, so the producer can
+ * reuse their slots (consumer only) */
+static inline void RingBufferIndex_release(RingBufferIndex_t* self,
+    uint32_t count) {
+    MEMORY_BARRIER();
+    self->tail += count;
+}
+
+// Releases every published item (consumer only)
+static inline void RingBufferIndex_clear(RingBufferIndex_t* self) {
+    MEMORY_BARRIER();
+    self->tail = self->head;
+}
+
+/* Writes the free-running index of the oldest item to tail and returns the
+ * number of published items, they may only be read after this (consumer
+ * only) */
+static inline uint32_t RingBufferIndex_snapshot(RingBufferIndex_t* self,
+    uint32_t* tail) {
+    uint32_t head = self->head;
+    MEMORY_BARRIER();
+    *tail = self->tail;
+    return head - *tail;
+}
+
+/* Declares a ring buffer type called name##_t holding items of the given type,
+ * along with its functions (name##_push, name##_pop...) and a snapshot type
+ * name##Snapshot_t used to iterate over the items, the indices are a
+ * RingBufferIndex_t and share its producer and consumer rules */
+#define RING_BUFFER_DECLARE(name, type, capacityLog2) \
+    typedef struct name { \
+        type data[RING_BUFFER_CAPACITY(capacityLog2)]; \
+        RingBufferIndex_t index; \
+    } name##_t; \
+    \
+    /* Consumer-side copy of the indices, the items it covers belong to the \
+     * consumer until they are dropped */ \
+    typedef struct name##Snapshot { \
+        type* data; \
+        uint32_t tail; \
+        uint32_t numItems; \
+    } name##Snapshot_t; \
+    \
+    static inline void name##_init(name##_t* self) { \
+        RingBufferIndex_init(&self->index); \
+    } \
+    \
+    static inline uint32_t name##_count(name##_t* self) { \
+        return RingBufferIndex_count(&self->index); \
+    } \
+    \
+    static inline uint32_t name##_space(name##_t* self) { \
+        return RING_BUFFER_CAPACITY(capacityLog2) - \
+            RingBufferIndex_count(&self->index); \
+    } \
+    \
+    /* Copies an item in at the head, returns 0 if the buffer is full \
+     * (producer only) */ \
+    static inline uint8_t name##_push(name##_t* self, const type* item) { \
+        uint32_t head; \
+        if(!RingBufferIndex_reserve(&self->index, \
+            RING_BUFFER_CAPACITY(capacityLog2), &head)) { \
+            return 0; \
+        } \
+        self->data[head & RING_BUFFER_MASK(capacityLog2)] = *item; \
+        RingBufferIndex_publish(&self->index, 1); \
+        return 1; \
+    } \
+    \
+    /* Returns the slot the next item will be written to, or NULL if the \
+     * buffer is full, the item is published with name##_publish (producer \
+     * only) */ \
+    static inline type* name##_headSlot(name##_t* self) { \
+        uint32_t head; \
+        if(!RingBufferIndex_reserve(&self->index, \
+            RING_BUFFER_CAPACITY(capacityLog2), &head)) { \
+            return 0; \
+        } \
+        return &self->data[head & RING_BUFFER_MASK(capacityLog2)]; \
+    } \
+    \
+    /* Publishes count items that were written in place at the head \
+     * (producer only) */ \
+    static inline void name##_publish(name##_t* self, uint32_t count) { \
+        RingBufferIndex_publish(&self->index, count); \
+    } \
+    \
+    /* Returns the free slots starting at the head that are contiguous in \
+     * memory, the number of slots is written to length (producer only) */ \
+    static inline type* name##_contiguousWrite(name##_t* self, \
+        uint32_t* length) { \
+        uint32_t head = self->index.head; \
+        uint32_t index = head & RING_BUFFER_MASK(capacityLog2); \
+        uint32_t space = RING_BUFFER_CAPACITY(capacityLog2) - \
+            (head - self->index.tail); \
+        uint32_t toEnd = RING_BUFFER_CAPACITY(capacityLog2) - index; \
+        *length = space < toEnd ? space : toEnd; \
+        return &self->data[index]; \
+    } \
+    \
+    /* Copies the oldest item out to item, which may be NULL, returns 0 if \
+     * the buffer is empty (consumer only) */ \
+    static inline uint8_t name##_pop(name##_t* self, type* item) { \
+        uint32_t tail; \
+        if(!RingBufferIndex_acquire(&self->index, &tail)) { \
+            return 0; \
+        } \
+        if(item) { \
+            *item = self->data[tail & RING_BUFFER_MASK(capacityLog2)]; \
+        } \
+        RingBufferIndex_release(&self->index, 1); \
+        return 1; \
+    } \
+    \
+    /* Returns the published items starting at the tail that are contiguous \
+     * in memory, the number of items is written to length (consumer only) */ \
+    static inline type* name##_contiguousRead(name##_t* self, \
+        uint32_t* length) { \
+        uint32_t tail; \
+        uint32_t count = RingBufferIndex_snapshot(&self->index, &tail); \
+        uint32_t index = tail & RING_BUFFER_MASK(capacityLog2); \
+        uint32_t toEnd = RING_BUFFER_CAPACITY(capacityLog2) - index; \
+        *length = count < toEnd ? count : toEnd; \
+        return &self->data[index]; \
+    } \
+    \
+    /* Releases the count oldest items (consumer only) */ \
+    static inline void name##_drop(name##_t* self, uint32_t count) { \
+        RingBufferIndex_release(&self->index, count); \
+    } \
+    \
+    /* Releases every published item (consumer only) */ \
+    static inline void name##_clear(name##_t* self) { \
+        RingBufferIndex_clear(&self->index); \
+    } \
+    \
+    /* Takes a snapshot of the published items (consumer only) */ \
+    static inline void name##_takeSnapshot(name##_t* self, \
+        name##Snapshot_t* snapshot) { \
+        snapshot->data = self->data; \
+        snapshot->numItems = RingBufferIndex_snapshot(&self->index, \
+            &snapshot->tail); \
+    } \
+    \
+    /* Returns the i-th item of a snapshot, starting from the oldest */ \
+    static inline type* name##_snapshotItem(name##Snapshot_t* snapshot, \
+        uint32_t i) { \
+        return &snapshot->data[(snapshot->tail + i) & \
+            RING_BUFFER_MASK(capacityLog2)]; \
+    }
+
+#endif /* RINGBUFFER_H_ */
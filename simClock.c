@@ -0,0 +1,99 @@
+/*
+ * simClock.c
+ *
+ *  Created on: Dec 9, 2016
+ *      Author: boer8364
+ */
+
+#include "simClock.h"
+
+#include "globalMacros.h"
+#include "hal.h"
+#include "power.h"
+
+SimClockStats_t simClockStats;
+
+// Simulation clock state, no ticks are pending at startup
+volatile uint16_t simTicksPending = 0;
+volatile uint16_t simClockOverflows = 0;
+
+// Timestamp of the start of the current frame
+static uint32_t frameStartTime = 0;
+// Number of frames skipped in a row
+static uint8_t consecutiveSkippedFrames = 0;
+
+uint32_t SimClock_now() {
+    return Hal_simTimerNow();
+}
+
+void SimClock_reset() {
+    // Drop any ticks that elapsed while the game was not running
+    simTicksPending = 0;
+
+    simClockStats.lastFrameTime = 0;
+    simClockStats.maxFrameTime = 0;
+    simClockStats.lastTicksPerFrame = 0;
+    simClockStats.totalTicks = 0;
+    simClockStats.droppedTicks = 0;
+    simClockStats.renderedFrames = 0;
+    simClockStats.skippedFrames = 0;
+
+    consecutiveSkippedFrames = 0;
+    frameStartTime = SimClock_now();
+}
+
+uint16_t SimClock_beginFrame() {
+    // Block until the simulation has a tick to run
+#ifdef POWER_FRAME_PACING
+    // Sleep out the rest of the frame budget
+    POWER_SLEEP_WHILE(!simTicksPending, POWER_MODE_LPM0);
+#else
+    while(!simTicksPending);
+#endif
+
+    // Take the pending ticks, the ISR must not update the count in between
+    DISABLE_INTERRUPTS();
+    uint16_t ticks = simTicksPending;
+    simTicksPending = 0;
+    ENABLE_INTERRUPTS();
+
+    // Clamp the number of ticks so that a slow frame can not snowball
+    if(ticks > SIM_MAX_TICKS_PER_FRAME) {
+        simClockStats.droppedTicks += ticks - SIM_MAX_TICKS_PER_FRAME;
+        ticks = SIM_MAX_TICKS_PER_FRAME;
+    }
+
+    simClockStats.lastTicksPerFrame = ticks;
+    simClockStats.totalTicks += ticks;
+
+    return ticks;
+}
+
+void SimClock_endFrame(uint8_t rendered) {
+    if(rendered) {
+        ++simClockStats.renderedFrames;
+        consecutiveSkippedFrames = 0;
+    } else {
+        ++simClockStats.skippedFrames;
+        ++consecutiveSkippedFrames;
+    }
+
+    // Measure the length of the frame
+    uint32_t now = SimClock_now();
+    simClockStats.lastFrameTime = now - frameStartTime;
+    if(simClockStats.lastFrameTime > simClockStats.maxFrameTime) {
+        simClockStats.maxFrameTime = simClockStats.lastFrameTime;
+    }
+    frameStartTime = now;
+}
+
+uint8_t SimClock_shouldSkipRender() {
+#ifdef SIM_FRAME_SKIP
+    /* If another tick is already due, the simulation is behind, so skip the
+     * drawing, but never skip too many frames in a row */
+    return simTicksPending > 0 &&
+        consecutiveSkippedFrames < SIM_MAX_SKIPPED_FRAMES;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,71 @@
+/*
+ * simClock.h
+ *
+ *  Created on: Dec 9, 2016
+ *      Author: boer8364
+ */
+
+#ifndef SIMCLOCK_H_
+#define SIMCLOCK_H_
+
+#include <inttypes.h>
+
+// The simulation clock counts ACLK cycles (REFOCLK, 32.768kHz)
+#define SIM_CLOCK_FREQUENCY 32768
+// ACLK cycles per simulation tick, this gives about 30 ticks per second
+#define SIM_TICK_PERIOD 1092
+/* Maximum number of ticks simulated in a single frame, if the game falls
+ * further behind than this, the extra ticks are dropped so that it can not
+ * spiral into simulating more and more ticks per frame */
+#define SIM_MAX_TICKS_PER_FRAME 4
+
+/* Render frame skipping flag, when enabled a frame is not drawn if the
+ * simulation is already behind by the time it is about to be rendered */
+#define SIM_FRAME_SKIP
+// Maximum number of frames that can be skipped in a row
+#define SIM_MAX_SKIPPED_FRAMES 2
+
+// Frame timing counters
+typedef struct SimClockStats {
+    // Length of the last frame in ACLK cycles
+    uint32_t lastFrameTime;
+    // Longest frame so far in ACLK cycles
+    uint32_t maxFrameTime;
+    // Number of simulation ticks run during the last frame
+    uint16_t lastTicksPerFrame;
+    // Total number of simulation ticks run
+    uint32_t totalTicks;
+    // Number of ticks dropped because the game fell too far behind
+    uint32_t droppedTicks;
+    // Number of frames that were rendered
+    uint32_t renderedFrames;
+    // Number of frames whose rendering was skipped
+    uint32_t skippedFrames;
+} SimClockStats_t;
+
+// Global instance of the counters
+extern SimClockStats_t simClockStats;
+
+/* Number of simulation ticks that have elapsed but have not been simulated
+ * yet, incremented by the simulation timer ISR */
+extern volatile uint16_t simTicksPending;
+// Number of times the simulation timer has overflowed
+extern volatile uint16_t simClockOverflows;
+
+// Returns a 32-bit timestamp in ACLK cycles
+uint32_t SimClock_now();
+
+// Drops pending ticks and resets the frame counters, call when a game starts
+void SimClock_reset();
+
+/* Marks the start of a frame and returns the number of ticks to simulate
+ * during it, blocks until at least one tick is due */
+uint16_t SimClock_beginFrame();
+// Marks the end of a frame, rendered is 0 if the frame was skipped
+void SimClock_endFrame(uint8_t rendered);
+
+/* Returns 1 if the frame about to be drawn should be skipped because the
+ * simulation has already fallen behind */
+uint8_t SimClock_shouldSkipRender();
+
+#endif /* SIMCLOCK_H_ */
@@ -35,15 +35,21 @@
 *****************************************************************************/
 
 #include <stdint.h>
+#include "globalMacros.h"
 
 /* Forward declaration of the default fault handlers. */
 static void resetISR(void);
 static void nmiISR(void);
 static void faultISR(void);
 static void defaultISR(void);
-extern void adc14ISR();
-extern void timerAISR();
 extern void port3ISR();
+extern void simTimerISR();
+extern void simTimerOverflowISR();
+#ifdef UART_DEBUG
+extern void uartTxISR();
+#else
+#define uartTxISR defaultISR
+#endif
 
 /* External declaration for the reset handler that is to be called when the */
 /* processor is started                                                     */
@@ -92,15 +98,15 @@ void (* const interruptVectors[])(void) =
     defaultISR,                             /* FLCTL ISR                 */
     defaultISR,                             /* COMP0 ISR                 */
     defaultISR,                             /* COMP1 ISR                 */
-    timerAISR,                             /* TA0_0 ISR                 */
+    defaultISR,                             /* TA0_0 ISR                 */
     defaultISR,                             /* TA0_N ISR                 */
     defaultISR,                             /* TA1_0 ISR                 */
     defaultISR,                             /* TA1_N ISR                 */
-    defaultISR,                             /* TA2_0 ISR                 */
-    defaultISR,                             /* TA2_N ISR                 */
+    simTimerISR,                             /* TA2_0 ISR                 */
+    simTimerOverflowISR,                             /* TA2_N ISR                 */
     defaultISR,                             /* TA3_0 ISR                 */
     defaultISR,                             /* TA3_N ISR                 */
-    defaultISR,                             /* EUSCIA0 ISR               */
+    uartTxISR,                             /* EUSCIA0 ISR               */
     defaultISR,                             /* EUSCIA1 ISR               */
     defaultISR,                             /* EUSCIA2 ISR               */
     defaultISR,                             /* EUSCIA3 ISR               */
@@ -108,7 +114,7 @@ void (* const interruptVectors[])(void) =
     defaultISR,                             /* EUSCIB1 ISR               */
     defaultISR,                             /* EUSCIB2 ISR               */
     defaultISR,                             /* EUSCIB3 ISR               */
-    adc14ISR,                             /* ADC14 ISR                 */
+    defaultISR,                             /* ADC14 ISR                 */
     defaultISR,                             /* T32_INT1 ISR              */
     defaultISR,                             /* T32_INT2 ISR              */
     defaultISR,                             /* T32_INTC ISR              */
@@ -0,0 +1,190 @@
+/*
+ * accelTool.c
+ *
+ *  Created on: Dec 14, 2016
+ *      Author: boer8364
+ *
+ * Host stand-in for the accelerometer sampling, feeds samples through the
+ * sample ring and filter at the rates the hardware uses and reports the
+ * noise, step latency and cost of a read. Samples come from a recording, one
+ * "x y" pair of raw 14-bit conversions per line, or from a synthetic noisy
+ * step when no recording is given. Build and run it from the project root
+ * with:
+ *
+ *   make accelTool
+ *   ./accelTool [recording]
+ */
+
+#ifdef HOST_BUILD
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "accelerometer.h"
+#include "hal.h"
+#include "prng.h"
+#include "simClock.h"
+
+// Length of the synthetic input, the step happens half way through
+#define SYNTHETIC_TICKS 240
+// Synthetic step from rest to a full tilt on x, in ADC counts
+#define SYNTHETIC_REST 8192
+#define SYNTHETIC_TILT (8192 + 3000)
+// Peak synthetic noise, in ADC counts
+#define SYNTHETIC_NOISE 64
+// Number of reads timed for the cost estimate
+#define TIMED_READS 1000000
+
+// Running mean and variance of a signal
+typedef struct Stats {
+    uint32_t count;
+    double mean;
+    double m2;
+} Stats_t;
+
+static void Stats_add(Stats_t* self, double value) {
+    ++self->count;
+    double delta = value - self->mean;
+    self->mean += delta / self->count;
+    self->m2 += delta * (value - self->mean);
+}
+
+static double Stats_deviation(Stats_t* self) {
+    return self->count > 1 ? sqrt(self->m2 / (self->count - 1)) : 0.0;
+}
+
+static Prng_t noisePrng;
+
+// Roughly normal noise, the sum of four uniform samples
+static int32_t noise() {
+    int32_t sum = 0;
+    uint8_t i = 0;
+    for(; i < 4; ++i) {
+        sum += (int32_t)Prng_nextBounded(&noisePrng, SYNTHETIC_NOISE + 1) -
+            SYNTHETIC_NOISE / 2;
+    }
+    return sum / 2;
+}
+
+/* Fetches the next x and y sample, from the recording if there is one,
+ * returns 0 when the input runs out */
+static int nextSample(FILE* recording, uint32_t sampleIndex,
+    uint32_t samplesPerTick, uint16_t* x, uint16_t* y) {
+    if(recording) {
+        unsigned int readX;
+        unsigned int readY;
+        if(fscanf(recording, "%u %u", &readX, &readY) != 2) {
+            return 0;
+        }
+        *x = (uint16_t)readX;
+        *y = (uint16_t)readY;
+        return 1;
+    }
+
+    if(sampleIndex >= SYNTHETIC_TICKS * samplesPerTick) {
+        return 0;
+    }
+    int32_t level = sampleIndex < SYNTHETIC_TICKS / 2 * samplesPerTick ?
+        SYNTHETIC_REST : SYNTHETIC_TILT;
+    *x = (uint16_t)(level + noise());
+    *y = (uint16_t)(SYNTHETIC_REST + noise());
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    FILE* recording = NULL;
+    if(argc > 1) {
+        recording = fopen(argv[1], "r");
+        if(!recording) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+    Prng_seed(&noisePrng, 1);
+
+    /* Both axes are converted once per two trigger periods, so this many
+     * pairs land in the ring every simulation tick */
+    const uint32_t samplesPerTick = SIM_TICK_PERIOD /
+        (2 * ACCELEROMETER_TRIGGER_PERIOD);
+
+    Stats_t rawStats = {0, 0.0, 0.0};
+    Stats_t filteredStats = {0, 0.0, 0.0};
+    uint32_t sampleIndex = 0;
+    uint32_t tick = 0;
+    int32_t stepTick = -1;
+    int32_t settledTick = -1;
+    const int32_t stepTarget = (SYNTHETIC_TILT - SYNTHETIC_REST) * 9 / 10;
+
+    Accelerometer_start();
+    int running = 1;
+    while(running) {
+        // Fill the ring with the conversions of one tick
+        uint32_t i = 0;
+        for(; i < samplesPerTick; ++i, ++sampleIndex) {
+            uint16_t x;
+            uint16_t y;
+            if(!nextSample(recording, sampleIndex, samplesPerTick, &x, &y)) {
+                running = 0;
+                break;
+            }
+            Hal_hostAdcPush(x);
+            Hal_hostAdcPush(y);
+            // Only the rest part of the synthetic input measures noise
+            if(recording || sampleIndex < SYNTHETIC_TICKS / 2 * samplesPerTick) {
+                Stats_add(&rawStats, (double)x);
+            }
+        }
+        if(!running) {
+            break;
+        }
+
+        // Read once per tick, as the game loop does
+        AccelerometerReading_t reading;
+        Accelerometer_read(&reading);
+        printf("%u,%d,%d\n", tick, reading.x, reading.y);
+
+        if(recording || tick < SYNTHETIC_TICKS / 2) {
+            // Skip the ticks the filter needs to settle after a start
+            if(tick >= 4) {
+                Stats_add(&filteredStats, (double)reading.x);
+            }
+        } else {
+            if(stepTick < 0) {
+                stepTick = (int32_t)tick;
+            }
+            if(settledTick < 0 && reading.x >= stepTarget) {
+                settledTick = (int32_t)tick;
+            }
+        }
+        ++tick;
+    }
+    if(recording) {
+        fclose(recording);
+    }
+
+    fprintf(stderr, "raw noise: %.2f counts\n", Stats_deviation(&rawStats));
+    fprintf(stderr, "filtered noise: %.2f counts\n",
+        Stats_deviation(&filteredStats));
+    if(settledTick >= 0) {
+        fprintf(stderr, "step latency to 90%%: %d ticks\n",
+            settledTick - stepTick);
+    }
+
+    // Time the read itself
+    struct timespec start;
+    struct timespec end;
+    AccelerometerReading_t reading;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t i = 0;
+    for(; i < TIMED_READS; ++i) {
+        Accelerometer_read(&reading);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) * 1e9 +
+        (end.tv_nsec - start.tv_nsec);
+    fprintf(stderr, "read cost: %.1f ns\n", elapsed / TIMED_READS);
+
+    return 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,138 @@
+/*
+ * benchCompare.c
+ *
+ *  Created on: Dec 23, 2016
+ *      Author: boer8364
+ *
+ * Host tool that compares two CSV outputs of the lcdDriver microbenchmarks in
+ * lcdBenchmark.c, usually a target build with RAMFUNC_DISABLE (the hot code
+ * runs from flash) against one without (it runs from SRAM), captured from the
+ * UART. A RAMFUNC function has no copy in flash that could be called, so the
+ * two placements can only be compared across two builds. Rows are matched by
+ * primitive and parameter and their minimums compared, the ratio is the time
+ * of the first file over the time of the second, above 1 the second is faster:
+ *
+ *   gcc -std=gnu99 -O2 -DHOST_BUILD -o benchCompare tools/benchCompare.c
+ *   ./benchCompare flash.csv sram.csv
+ */
+
+#ifdef HOST_BUILD
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Enough for every case and parameter of lcdBenchmark.c
+#define MAX_ROWS 128
+
+typedef struct Row {
+    char primitive[32];
+    int param;
+    unsigned long min;
+    unsigned long average;
+} Row_t;
+
+typedef struct Results {
+    Row_t rows[MAX_ROWS];
+    uint16_t numRows;
+    // What the code column says, sram, flash or host
+    char code[8];
+} Results_t;
+
+/* Reads the next line, the target ends its lines with a carriage return so
+ * both end a line, empty lines are skipped */
+static uint8_t readLine(FILE* file, char* line, size_t size) {
+    size_t length = 0;
+    int c;
+    while((c = fgetc(file)) != EOF) {
+        if(c == '\r' || c == '\n') {
+            if(length) {
+                break;
+            }
+        } else if(length + 1 < size) {
+            line[length++] = (char)c;
+        }
+    }
+    line[length] = '\0';
+    return length > 0;
+}
+
+static uint8_t load(const char* path, Results_t* results) {
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        fprintf(stderr, "Can not open %s\n", path);
+        return 0;
+    }
+    char line[256];
+    results->numRows = 0;
+    strcpy(results->code, "?");
+    while(readLine(file, line, sizeof(line)) && results->numRows < MAX_ROWS) {
+        Row_t* row = &results->rows[results->numRows];
+        unsigned int iterations;
+        unsigned long max;
+        char code[8] = "";
+        // The header row and whatever else the UART picked up do not parse
+        if(sscanf(line, "%31[^,],%d,%u,%lu,%lu,%lu,%7s", row->primitive,
+            &row->param, &iterations, &row->min, &row->average, &max,
+            code) >= 6) {
+            if(code[0]) {
+                strcpy(results->code, code);
+            }
+            ++results->numRows;
+        }
+    }
+    fclose(file);
+    if(!results->numRows) {
+        fprintf(stderr, "%s: no benchmark results\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+static Results_t first;
+static Results_t second;
+
+int main(int argc, char** argv) {
+    if(argc != 3) {
+        fprintf(stderr, "usage: %s first.csv second.csv\n", argv[0]);
+        return 1;
+    }
+    if(!load(argv[1], &first) || !load(argv[2], &second)) {
+        return 1;
+    }
+
+    printf("%-20s %6s %10s %10s %7s\n", "primitive", "param", first.code,
+        second.code, "ratio");
+    uint16_t matched = 0;
+    uint16_t i = 0;
+    for(; i < first.numRows; ++i) {
+        const Row_t* a = &first.rows[i];
+        uint16_t j = 0;
+        for(; j < second.numRows; ++j) {
+            const Row_t* b = &second.rows[j];
+            if(a->param == b->param && !strcmp(a->primitive, b->primitive)) {
+                break;
+            }
+        }
+        if(j == second.numRows) {
+            continue;
+        }
+        const Row_t* b = &second.rows[j];
+        if(b->min) {
+            printf("%-20s %6d %10lu %10lu %7.2f\n", a->primitive, a->param,
+                a->min, b->min, (double)a->min / b->min);
+        } else {
+            printf("%-20s %6d %10lu %10lu %7s\n", a->primitive, a->param,
+                a->min, b->min, "-");
+        }
+        ++matched;
+    }
+    if(matched != first.numRows || matched != second.numRows) {
+        fprintf(stderr, "%u of %u and %u rows matched\n", matched,
+            first.numRows, second.numRows);
+    }
+    return 0;
+}
+
+#endif
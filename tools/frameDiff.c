@@ -0,0 +1,246 @@
+/*
+ * frameDiff.c
+ *
+ *  Created on: Dec 22, 2016
+ *      Author: boer8364
+ *
+ * Golden image comparator for the host frame captures (frameCapture.h).
+ * Compares two captures of the same replayed input frame by frame and lists
+ * every frame with a pixel difference, with the number of pixels that differ
+ * and their bounding box. With -o, the first differing frame is saved as a
+ * PPM with the differing pixels in red over the dimmed golden frame. Exits
+ * with 1 if the captures differ in any pixel or in length. Both captures must
+ * be in the same format, a multi-image PPM, a PPM sequence (a printf format)
+ * or a Y4M stream. Build and run it from the project root with:
+ *
+ *   make frameDiff
+ *   ./frameDiff [-o diff.ppm] golden.ppm run.ppm
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "frameCapture.h"
+#include "lcdDriver.h"
+
+#define FRAME_PIXELS (LCD_SCREEN_WIDTH * LCD_SCREEN_HEIGHT)
+// Differing frames listed before the rest are only counted
+#define MAX_LISTED_FRAMES 20
+
+typedef struct Capture {
+    const char* path;
+    CaptureFormat_t format;
+    // Stream being read, or the current file of a sequence
+    FILE* file;
+    uint32_t frame;
+} Capture_t;
+
+// Frames of both captures, 3 bytes per pixel
+static uint8_t frames[2][3 * FRAME_PIXELS];
+
+// Reads a PPM header, returns 0 at the end or if it is not a capture frame
+static uint8_t readPpmHeader(FILE* file, const char* path) {
+    unsigned int width;
+    unsigned int height;
+    unsigned int maxValue;
+    if(fscanf(file, " P6 %u %u %u", &width, &height, &maxValue) != 3) {
+        return 0;
+    }
+    fgetc(file);
+    if(width != LCD_SCREEN_WIDTH || height != LCD_SCREEN_HEIGHT ||
+        maxValue != 255) {
+        fprintf(stderr, "%s: not a %ux%u capture\n", path, LCD_SCREEN_WIDTH,
+            LCD_SCREEN_HEIGHT);
+        return 0;
+    }
+    return 1;
+}
+
+static uint8_t openCapture(Capture_t* capture, const char* path) {
+    capture->path = path;
+    capture->frame = 0;
+    capture->file = NULL;
+    capture->format = FrameCapture_format(path);
+    if(capture->format == CAPTURE_FORMAT_PPM_SEQUENCE) {
+        return 1;
+    }
+
+    capture->file = fopen(path, "rb");
+    if(!capture->file) {
+        fprintf(stderr, "Can not open %s\n", path);
+        return 0;
+    }
+    if(capture->format == CAPTURE_FORMAT_Y4M) {
+        char header[256];
+        unsigned int width = 0;
+        unsigned int height = 0;
+        if(!fgets(header, sizeof(header), capture->file) ||
+            strncmp(header, "YUV4MPEG2 ", 10) ||
+            !strstr(header, " C444")) {
+            fprintf(stderr, "%s: not a 4:4:4 Y4M stream\n", path);
+            return 0;
+        }
+        char* field = strstr(header, " W");
+        if(field) {
+            sscanf(field, " W%u", &width);
+        }
+        field = strstr(header, " H");
+        if(field) {
+            sscanf(field, " H%u", &height);
+        }
+        if(width != LCD_SCREEN_WIDTH || height != LCD_SCREEN_HEIGHT) {
+            fprintf(stderr, "%s: not a %ux%u capture\n", path,
+                LCD_SCREEN_WIDTH, LCD_SCREEN_HEIGHT);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Reads the next frame as 3 bytes per pixel, Y4M planes are interleaved,
+ * returns 0 at the end of the capture */
+static uint8_t readFrame(Capture_t* capture, uint8_t* frame) {
+    if(capture->format == CAPTURE_FORMAT_PPM_SEQUENCE) {
+        char name[256];
+        snprintf(name, sizeof(name), capture->path, capture->frame);
+        FILE* file = fopen(name, "rb");
+        if(!file) {
+            return 0;
+        }
+        uint8_t read = readPpmHeader(file, name) &&
+            fread(frame, 1, 3 * FRAME_PIXELS, file) == 3 * FRAME_PIXELS;
+        fclose(file);
+        capture->frame += read;
+        return read;
+    }
+
+    if(capture->format == CAPTURE_FORMAT_Y4M) {
+        static uint8_t planes[3 * FRAME_PIXELS];
+        char line[64];
+        if(!fgets(line, sizeof(line), capture->file) ||
+            strncmp(line, "FRAME", 5) ||
+            fread(planes, 1, sizeof(planes), capture->file) !=
+            sizeof(planes)) {
+            return 0;
+        }
+        uint32_t i = 0;
+        for(; i < FRAME_PIXELS; ++i) {
+            frame[3 * i] = planes[i];
+            frame[3 * i + 1] = planes[FRAME_PIXELS + i];
+            frame[3 * i + 2] = planes[2 * FRAME_PIXELS + i];
+        }
+    } else if(!readPpmHeader(capture->file, capture->path) ||
+        fread(frame, 1, 3 * FRAME_PIXELS, capture->file) != 3 * FRAME_PIXELS) {
+        return 0;
+    }
+    ++capture->frame;
+    return 1;
+}
+
+// Saves the differences, red over the dimmed golden frame
+static void writeDiff(const char* path, const uint8_t* golden,
+    const uint8_t* frame) {
+    static uint8_t image[3 * FRAME_PIXELS];
+    uint32_t i = 0;
+    for(; i < FRAME_PIXELS; ++i) {
+        if(memcmp(&golden[3 * i], &frame[3 * i], 3)) {
+            image[3 * i] = 255;
+            image[3 * i + 1] = 0;
+            image[3 * i + 2] = 0;
+        } else {
+            image[3 * i] = golden[3 * i] / 4;
+            image[3 * i + 1] = golden[3 * i + 1] / 4;
+            image[3 * i + 2] = golden[3 * i + 2] / 4;
+        }
+    }
+    FILE* file = fopen(path, "wb");
+    if(!file) {
+        fprintf(stderr, "Can not write %s\n", path);
+        return;
+    }
+    fprintf(file, "P6\n%u %u\n255\n", LCD_SCREEN_WIDTH, LCD_SCREEN_HEIGHT);
+    fwrite(image, 1, sizeof(image), file);
+    fclose(file);
+}
+
+int main(int argc, char** argv) {
+    const char* diffPath = NULL;
+    const char* paths[2];
+    int numPaths = 0;
+    int i = 1;
+    for(; i < argc; ++i) {
+        if(!strcmp(argv[i], "-o") && i + 1 < argc) {
+            diffPath = argv[++i];
+        } else if(numPaths < 2) {
+            paths[numPaths++] = argv[i];
+        } else {
+            numPaths = 0;
+            break;
+        }
+    }
+    if(numPaths != 2) {
+        fprintf(stderr, "usage: %s [-o diff.ppm] golden run\n", argv[0]);
+        return 1;
+    }
+
+    Capture_t captures[2];
+    if(!openCapture(&captures[0], paths[0]) ||
+        !openCapture(&captures[1], paths[1])) {
+        return 1;
+    }
+    if(captures[0].format != captures[1].format) {
+        fprintf(stderr, "The captures are in different formats\n");
+        return 1;
+    }
+
+    uint32_t compared = 0;
+    uint32_t differing = 0;
+    while(1) {
+        uint8_t goldenRead = readFrame(&captures[0], frames[0]);
+        uint8_t frameRead = readFrame(&captures[1], frames[1]);
+        if(!goldenRead || !frameRead) {
+            if(goldenRead != frameRead) {
+                printf("%s ends after %u frames\n",
+                    goldenRead ? paths[1] : paths[0], compared);
+                ++differing;
+            }
+            break;
+        }
+
+        uint32_t pixels = 0;
+        uint32_t x0 = LCD_SCREEN_WIDTH;
+        uint32_t y0 = LCD_SCREEN_HEIGHT;
+        uint32_t x1 = 0;
+        uint32_t y1 = 0;
+        uint32_t pixel = 0;
+        for(; pixel < FRAME_PIXELS; ++pixel) {
+            if(!memcmp(&frames[0][3 * pixel], &frames[1][3 * pixel], 3)) {
+                continue;
+            }
+            uint32_t x = pixel % LCD_SCREEN_WIDTH;
+            uint32_t y = pixel / LCD_SCREEN_WIDTH;
+            ++pixels;
+            x0 = x < x0 ? x : x0;
+            y0 = y < y0 ? y : y0;
+            x1 = x > x1 ? x : x1;
+            y1 = y > y1 ? y : y1;
+        }
+        if(pixels) {
+            if(differing < MAX_LISTED_FRAMES) {
+                printf("frame %u: %u pixels differ in (%u, %u) to (%u, %u)\n",
+                    compared, pixels, x0, y0, x1, y1);
+            }
+            if(!differing && diffPath) {
+                writeDiff(diffPath, frames[0], frames[1]);
+            }
+            ++differing;
+        }
+        ++compared;
+    }
+
+    printf("%u frames compared, %u differ\n", compared, differing);
+    return differing != 0;
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * inputTool.c
+ *
+ *  Created on: Dec 15, 2016
+ *      Author: boer8364
+ *
+ * Host tool that checks the integer input mapping against the original
+ * floating point one over the whole range of readings, and prints the
+ * response of the built-in curves:
+ *
+ *   make inputTool
+ *   ./inputTool [deadZone]
+ */
+
+#ifdef HOST_BUILD
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "input.h"
+#include "player.h"
+
+// Readings are checked on a grid with this spacing, in ADC counts
+#define GRID_STEP 7
+// Largest reading checked, a little past a full tilt
+#define GRID_LIMIT 4096
+
+// The original mapping, in sub-pixels
+static void referenceMap(const AccelerometerReading_t* reading,
+    double* x, double* y) {
+    double tiltX = (double)reading->x;
+    double tiltY = (double)-reading->y;
+    double magnitude = sqrt(tiltX * tiltX + tiltY * tiltY);
+    double speed = PLAYER_SPEED * magnitude / 3095.96;
+    double scale = magnitude > 0.0 ? speed / magnitude : 0.0;
+    *x = tiltX * scale * (1 << INPUT_VELOCITY_FRACTION_BITS);
+    *y = tiltY * scale * (1 << INPUT_VELOCITY_FRACTION_BITS);
+}
+
+// Prints the speed along the x axis for a range of tilts
+static void printResponse(const char* name, const InputConfig_t* config) {
+    printf("%s (dead zone %u):", name, config->deadZone);
+    int16_t tilt = 0;
+    for(; tilt <= INPUT_MAX_MAGNITUDE; tilt += INPUT_MAX_MAGNITUDE / 8) {
+        AccelerometerReading_t reading = {tilt, 0};
+        InputVelocity_t velocity;
+        Input_map(config, &reading, &velocity);
+        printf(" %.2f", INPUT_VELOCITY_TO_DOUBLE(velocity.x));
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    uint16_t deadZone = argc > 1 ? (uint16_t)atoi(argv[1]) : 150;
+
+    // The default mapping must match the original within one sub-pixel
+    InputConfig_t linear = {0, NULL};
+    double maxError = 0.0;
+    int16_t x = -GRID_LIMIT;
+    for(; x <= GRID_LIMIT; x += GRID_STEP) {
+        int16_t y = -GRID_LIMIT;
+        for(; y <= GRID_LIMIT; y += GRID_STEP) {
+            AccelerometerReading_t reading = {x, y};
+            InputVelocity_t velocity;
+            Input_map(&linear, &reading, &velocity);
+
+            double referenceX;
+            double referenceY;
+            referenceMap(&reading, &referenceX, &referenceY);
+            double errorX = fabs(velocity.x - referenceX);
+            double errorY = fabs(velocity.y - referenceY);
+            if(errorX > maxError) {
+                maxError = errorX;
+            }
+            if(errorY > maxError) {
+                maxError = errorY;
+            }
+        }
+    }
+    printf("linear mapping max error: %.3f sub-pixels\n", maxError);
+
+    InputConfig_t deadZoneLinear = {deadZone, NULL};
+    InputConfig_t curvedLinear = {deadZone, INPUT_CURVE_LINEAR};
+    InputConfig_t curvedQuadratic = {deadZone, INPUT_CURVE_QUADRATIC};
+    printResponse("linear", &linear);
+    printResponse("linear", &deadZoneLinear);
+    printResponse("linear curve", &curvedLinear);
+    printResponse("quadratic curve", &curvedQuadratic);
+
+    return maxError <= 1.0 ? 0 : 1;
+}
+
+#endif /* HOST_BUILD */
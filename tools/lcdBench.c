@@ -0,0 +1,41 @@
+/*
+ * lcdBench.c
+ *
+ *  Created on: Dec 21, 2016
+ *      Author: boer8364
+ *
+ * Host runner for the lcdDriver microbenchmarks in lcdBenchmark.c, prints the
+ * timings in nanoseconds as CSV, or as JSON with -json. The debug flags are
+ * left off so that the primitives are timed without the counter and profiler
+ * hooks. The send cases include the cost of the halHost.c panel model. Build
+ * and run it from the project root with:
+ *
+ *   make lcdBench
+ *   ./lcdBench [-json]
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "lcdDriver.h"
+#include "lcdBenchmark.h"
+
+int main(int argc, char** argv) {
+    LcdBenchmarkFormat_t format = LCD_BENCHMARK_CSV;
+    int i = 1;
+    for(; i < argc; ++i) {
+        if(!strcmp(argv[i], "-json")) {
+            format = LCD_BENCHMARK_JSON;
+        } else {
+            fprintf(stderr, "usage: %s [-json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    LCD_init();
+    LcdBenchmark_run(format);
+    return 0;
+}
+
+#endif
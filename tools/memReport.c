@@ -0,0 +1,322 @@
+/*
+ * memReport.c
+ *
+ *  Created on: Dec 22, 2016
+ *      Author: boer8364
+ *
+ * Host tool that breaks the RAM and flash use of a target image down by
+ * subsystem, from the section allocation map of the linker map file the CCS
+ * project writes (Debug/<project>.map). Every input section is attributed to
+ * its object file, and the object files to the subsystems below, library code
+ * counts as the runtime. Uninitialized globals that the compiler made common
+ * symbols carry no object file in the map and are listed as common. RAMFUNC
+ * code is loaded into flash and copied into SRAM at start-up, it counts for
+ * both and its SRAM size is reported on its own. With -v the report lists
+ * every input section. The RAM and flash totals are checked against the
+ * budgets, the whole device by default, and the RAM of the output sections
+ * against the section budgets of memoryBudget.h, the exit code is 1 if any
+ * one is exceeded. The CCS project runs it on its map as a post-build step,
+ * through make memReportPostBuild, which skips it when there is no host gcc.
+ * tools/memReportSample.map is a trimmed map that make check runs it on:
+ *
+ *   make memReport
+ *   ./memReport [-v] [-ram bytes] [-flash bytes] Debug/LuigisOcean.map
+ */
+
+#ifdef HOST_BUILD
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memoryBudget.h"
+
+// Flash of the MSP432P401R, main and information memory
+#define FLASH_SIZE (256 * 1024)
+
+// Memory ranges, the SRAM is mapped twice, for code and for data
+#define IS_FLASH(address) ((address) < 0x00040000 || \
+    ((address) >= 0x00200000 && (address) < 0x00204000))
+#define IS_RAM(address) (((address) >= 0x01000000 && \
+    (address) < 0x01010000) || ((address) >= 0x20000000 && \
+    (address) < 0x20010000))
+
+typedef struct Subsystem {
+    const char* name;
+    // Object files of the subsystem, NULL terminated
+    const char* objects[12];
+    uint32_t ram;
+    uint32_t flash;
+} Subsystem_t;
+
+// The last entries catch what the object files do not name
+static Subsystem_t subsystems[] = {
+    {"display", {"lcdDriver", "bitmaps", NULL}, 0, 0},
+    {"game", {"main", "player", "wall", "wallBuffer", "pattern",
+        "collision", "vector2d", "prng", "input", NULL}, 0, 0},
+    {"platform", {"halMsp432", "myISR", "startup_msp432p401r_ccs",
+        "system_msp432p401r", "power", "simClock", "accelerometer",
+        "clock", NULL}, 0, 0},
+    {"debug", {"uartLogger", "log", "trace", "profiler", "counters",
+        "replay", "replayStream", "overdraw", "lcdBenchmark", NULL}, 0, 0},
+    {"runtime", {NULL}, 0, 0},
+    {"stack", {NULL}, 0, 0},
+    {"heap", {NULL}, 0, 0},
+    {"common", {NULL}, 0, 0},
+    {"init tables", {NULL}, 0, 0},
+    {"padding", {NULL}, 0, 0},
+    {"other", {NULL}, 0, 0}
+};
+
+#define NUM_SUBSYSTEMS (sizeof(subsystems) / sizeof(subsystems[0]))
+
+typedef struct SectionBudget {
+    const char* name;
+    // Output sections that count towards the budget, NULL terminated
+    const char* sections[4];
+    uint32_t budget;
+    // RAM the sections take up, the SRAM code is added up separately
+    uint32_t used;
+} SectionBudget_t;
+
+// The budgets of memoryBudget.h, the last entry is the copied RAMFUNC code
+static SectionBudget_t sectionBudgets[] = {
+    {"framebuffer", {".framebuffer", NULL}, MEMORY_BUDGET_FRAMEBUFFER, 0},
+    {"debug buffers", {".debugbuffers", NULL}, MEMORY_BUDGET_DEBUG_BUFFERS,
+        0},
+    {"other", {".data", ".bss", ".vtable", NULL}, MEMORY_BUDGET_OTHER, 0},
+    {"stack", {".stack", NULL}, MEMORY_STACK_SIZE, 0},
+    {"sram code", {NULL}, MEMORY_BUDGET_RAMFUNC, 0}
+};
+
+#define NUM_SECTION_BUDGETS \
+    (sizeof(sectionBudgets) / sizeof(sectionBudgets[0]))
+
+// Counts the RAM of an output section towards the budget that covers it
+static void addSection(const char* section, uint32_t address,
+    uint32_t length) {
+    if(!IS_RAM(address)) {
+        return;
+    }
+    uint8_t i = 0;
+    for(; i < NUM_SECTION_BUDGETS; ++i) {
+        uint8_t j = 0;
+        for(; sectionBudgets[i].sections[j]; ++j) {
+            if(!strcmp(sectionBudgets[i].sections[j], section)) {
+                sectionBudgets[i].used += length;
+                return;
+            }
+        }
+    }
+}
+
+// Looks up a subsystem by name, the names above are all known
+static Subsystem_t* named(const char* name) {
+    uint8_t i = 0;
+    for(; i < NUM_SUBSYSTEMS; ++i) {
+        if(!strcmp(subsystems[i].name, name)) {
+            break;
+        }
+    }
+    return &subsystems[i];
+}
+
+/* Attributes an input section, the description is what follows the address
+ * and length in the map: "file.obj (.section)", "library : file.obj
+ * (.section)", "(.common:symbol)" or "--HOLE--" */
+static Subsystem_t* attribute(const char* description) {
+    if(strstr(description, "--HOLE--")) {
+        return named("padding");
+    }
+    if(strstr(description, " : ")) {
+        return named("runtime");
+    }
+    if(!strncmp(description, "(.common:", 9)) {
+        return named("common");
+    }
+
+    // The object file name without its extension
+    char object[128];
+    size_t length = strcspn(description, ". (");
+    if(length >= sizeof(object)) {
+        return named("other");
+    }
+    memcpy(object, description, length);
+    object[length] = '\0';
+
+    uint8_t i = 0;
+    for(; i < NUM_SUBSYSTEMS; ++i) {
+        uint8_t j = 0;
+        for(; subsystems[i].objects[j]; ++j) {
+            if(!strcmp(subsystems[i].objects[j], object)) {
+                return &subsystems[i];
+            }
+        }
+    }
+    return named("other");
+}
+
+static void add(Subsystem_t* subsystem, uint32_t address, uint32_t length) {
+    if(IS_RAM(address)) {
+        subsystem->ram += length;
+    } else if(IS_FLASH(address)) {
+        subsystem->flash += length;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    uint8_t verbose = 0;
+    uint32_t ramBudget = MEMORY_RAM_SIZE;
+    uint32_t flashBudget = FLASH_SIZE;
+    int i = 1;
+    for(; i < argc; ++i) {
+        if(!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        } else if(!strcmp(argv[i], "-ram") && i + 1 < argc) {
+            ramBudget = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if(!strcmp(argv[i], "-flash") && i + 1 < argc) {
+            flashBudget = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            path = argv[i];
+        }
+    }
+    if(!path) {
+        fprintf(stderr, "usage: %s [-v] [-ram bytes] [-flash bytes] map\n",
+            argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        fprintf(stderr, "Can not open %s\n", path);
+        return 1;
+    }
+
+    char line[512];
+    uint8_t inMap = 0;
+    // Output section being read and what its input sections added up to
+    char section[64] = "";
+    char pendingName[64] = "";
+    uint32_t sectionAddress = 0;
+    uint32_t sectionLength = 0;
+    uint32_t inputLength = 0;
+    /* Run address of a section that is copied at start-up, the map lists its
+     * input sections at their load addresses */
+    uint32_t runAddress = 0;
+    uint32_t sramCode = 0;
+    while(fgets(line, sizeof(line), file)) {
+        if(!inMap) {
+            inMap = !strncmp(line, "SECTION ALLOCATION MAP", 22);
+            continue;
+        }
+        if(!strncmp(line, "MODULE SUMMARY", 14) ||
+            !strncmp(line, "GLOBAL SYMBOLS", 14) ||
+            !strncmp(line, "LINKER GENERATED", 16)) {
+            break;
+        }
+
+        unsigned int page;
+        unsigned int address;
+        unsigned int length;
+        int consumed;
+        /* Output sections start in the first column, a long name goes on a
+         * line of its own and its fields follow on the next one after a * */
+        uint8_t isSection = 0;
+        if(line[0] == '.') {
+            int fields = sscanf(line, "%63s %u %x %x", pendingName, &page,
+                &address, &length);
+            isSection = fields == 4;
+        } else if(line[0] == '*' && pendingName[0]) {
+            isSection = sscanf(line, "* %u %x %x", &page, &address,
+                &length) == 3;
+        }
+        if(isSection) {
+            // An output section without input sections is a reservation
+            if(section[0] && !inputLength) {
+                add(named(!strcmp(section, ".stack") ? "stack" :
+                    !strcmp(section, ".sysmem") ? "heap" : "other"),
+                    sectionAddress, sectionLength);
+            }
+            strcpy(section, pendingName);
+            pendingName[0] = '\0';
+            addSection(section, address, length);
+            sectionAddress = address;
+            sectionLength = length;
+            inputLength = 0;
+            char* run = strstr(line, "RUN ADDR = ");
+            runAddress = run ? (uint32_t)strtoul(run + 11, NULL, 16) : 0;
+        } else if(line[0] == ' ' && section[0] && sscanf(line, " %x %x %n",
+            &address, &length, &consumed) == 2) {
+            char* description = line + consumed;
+            description[strcspn(description, "\r\n")] = '\0';
+            // The initialization tables hold the initial values of .data
+            Subsystem_t* subsystem = !strcmp(section, ".cinit") ?
+                named("init tables") : attribute(description);
+            add(subsystem, address, length);
+            if(runAddress && IS_RAM(runAddress)) {
+                add(subsystem, runAddress, length);
+                sramCode += length;
+            }
+            inputLength += length;
+            if(verbose) {
+                printf("%-14s %08x %6u  %-12s %s\n", section, address, length,
+                    subsystem->name, description);
+            }
+        }
+    }
+    if(section[0] && !inputLength) {
+        add(named(!strcmp(section, ".stack") ? "stack" :
+            !strcmp(section, ".sysmem") ? "heap" : "other"),
+            sectionAddress, sectionLength);
+    }
+    fclose(file);
+    if(!inMap) {
+        fprintf(stderr, "%s: no section allocation map\n", path);
+        return 1;
+    }
+
+    uint32_t ram = 0;
+    uint32_t flash = 0;
+    printf("%-14s %8s %8s\n", "subsystem", "ram", "flash");
+    uint8_t s = 0;
+    for(; s < NUM_SUBSYSTEMS; ++s) {
+        if(subsystems[s].ram || subsystems[s].flash) {
+            printf("%-14s %8u %8u\n", subsystems[s].name, subsystems[s].ram,
+                subsystems[s].flash);
+        }
+        ram += subsystems[s].ram;
+        flash += subsystems[s].flash;
+    }
+    printf("%-14s %8u %8u\n", "total", ram, flash);
+    printf("%-14s %8u %8u\n\n", "budget", ramBudget, flashBudget);
+
+    sectionBudgets[NUM_SECTION_BUDGETS - 1].used = sramCode;
+    printf("%-14s %8s %8s\n", "section", "ram", "budget");
+    for(s = 0; s < NUM_SECTION_BUDGETS; ++s) {
+        printf("%-14s %8u %8u\n", sectionBudgets[s].name,
+            sectionBudgets[s].used, sectionBudgets[s].budget);
+    }
+
+    uint8_t exceeded = 0;
+    if(ram > ramBudget) {
+        fprintf(stderr, "RAM budget exceeded by %u bytes\n", ram - ramBudget);
+        exceeded = 1;
+    }
+    if(flash > flashBudget) {
+        fprintf(stderr, "Flash budget exceeded by %u bytes\n",
+            flash - flashBudget);
+        exceeded = 1;
+    }
+    for(s = 0; s < NUM_SECTION_BUDGETS; ++s) {
+        if(sectionBudgets[s].used > sectionBudgets[s].budget) {
+            fprintf(stderr, "%s budget exceeded by %u bytes\n",
+                sectionBudgets[s].name,
+                sectionBudgets[s].used - sectionBudgets[s].budget);
+            exceeded = 1;
+        }
+    }
+    return exceeded;
+}
+
+#endif
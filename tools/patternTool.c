@@ -0,0 +1,174 @@
+/*
+ * patternTool.c
+ *
+ *  Created on: Dec 13, 2016
+ *      Author: boer8364
+ *
+ * Host tool that validates the wall patterns in the pattern library and runs
+ * the pattern engine headless, printing every wall it spawns. Exits with 1
+ * if a pattern is broken:
+ *
+ *   make patternTool
+ *   ./patternTool [ticks] [seed] [spawnPeriod]
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pattern.h"
+
+// Patterns longer than this are assumed to be missing their end opcode
+#define PATTERN_TOOL_MAX_LENGTH 256
+
+/* Smallest distance between the two gaps of a wall, in gap positions, so that
+ * the gaps do not run into each other */
+#define PATTERN_TOOL_MIN_GAP_DISTANCE \
+    ((WALL_GAP_BINARY_LENGTH + (65536 / WALL_ANGLE_GENERATION_RESOLUTION) - 1) / \
+    (65536 / WALL_ANGLE_GENERATION_RESOLUTION))
+
+// Reports a problem with a pattern, returns 1 so that errors can be counted
+static int reportError(uint8_t patternIndex, uint32_t offset,
+    const char* message) {
+    fprintf(stderr, "pattern %u, byte %u: %s\n", patternIndex, offset,
+        message);
+    return 1;
+}
+
+static int checkGap(uint8_t patternIndex, uint32_t offset, uint8_t gap) {
+    if(gap >= WALL_ANGLE_GENERATION_RESOLUTION) {
+        return reportError(patternIndex, offset, "gap out of range");
+    }
+    return 0;
+}
+
+// Checks a single pattern, returns the number of problems found
+static int validatePattern(uint8_t patternIndex) {
+    const uint8_t* pattern = PATTERN_LIBRARY[patternIndex];
+    int errors = 0;
+    uint8_t spawns = 0;
+    uint32_t offset = 0;
+
+    while(offset < PATTERN_TOOL_MAX_LENGTH) {
+        uint8_t op = pattern[offset];
+        if(op >= PATTERN_NUM_OPS) {
+            // The operand count is unknown, so the rest can not be decoded
+            return errors + reportError(patternIndex, offset,
+                "unknown opcode");
+        }
+
+        const uint8_t* operands = pattern + offset + 1;
+        switch(op) {
+        case PATTERN_OP_END:
+            if(!spawns) {
+                errors += reportError(patternIndex, offset,
+                    "pattern never spawns a wall");
+            }
+            return errors;
+        case PATTERN_OP_WALL:
+            errors += checkGap(patternIndex, offset, operands[0]);
+            ++spawns;
+            break;
+        case PATTERN_OP_WALL2: {
+            errors += checkGap(patternIndex, offset, operands[0]);
+            errors += checkGap(patternIndex, offset, operands[1]);
+            // The operands promote to int, keep the difference positive
+            uint8_t distance = (operands[1] - operands[0] +
+                WALL_ANGLE_GENERATION_RESOLUTION) %
+                WALL_ANGLE_GENERATION_RESOLUTION;
+            if(distance < PATTERN_TOOL_MIN_GAP_DISTANCE ||
+                WALL_ANGLE_GENERATION_RESOLUTION - distance <
+                PATTERN_TOOL_MIN_GAP_DISTANCE) {
+                errors += reportError(patternIndex, offset,
+                    "gaps overlap");
+            }
+            ++spawns;
+            break;
+        }
+        case PATTERN_OP_RANDOM:
+            ++spawns;
+            break;
+        case PATTERN_OP_SPIRAL:
+            errors += checkGap(patternIndex, offset, operands[0]);
+            if(operands[1] == 0 ||
+                operands[1] >= WALL_ANGLE_GENERATION_RESOLUTION) {
+                errors += reportError(patternIndex, offset,
+                    "spiral step out of range");
+            }
+            // Spirals share the count check with alternating runs
+            // Fall through
+        case PATTERN_OP_ALTERNATE:
+            if(op == PATTERN_OP_ALTERNATE) {
+                errors += checkGap(patternIndex, offset, operands[0]);
+                errors += checkGap(patternIndex, offset, operands[1]);
+            }
+            if(operands[2] == 0) {
+                errors += reportError(patternIndex, offset, "zero count");
+            }
+            ++spawns;
+            break;
+        case PATTERN_OP_WAIT:
+            break;
+        case PATTERN_OP_SPACING:
+            // 0 is allowed, it restores the difficulty spawn period
+            break;
+        case PATTERN_OP_BURST:
+            if(operands[0] == 0) {
+                errors += reportError(patternIndex, offset, "zero count");
+            }
+            if(operands[1] == 0) {
+                errors += reportError(patternIndex, offset,
+                    "zero burst spacing");
+            }
+            break;
+        }
+
+        offset += 1 + PATTERN_OPERAND_COUNT[op];
+    }
+
+    return errors + reportError(patternIndex, offset, "missing END");
+}
+
+int main(int argc, char** argv) {
+    uint32_t ticks = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 1;
+    uint8_t spawnPeriod = argc > 3 ?
+        (uint8_t)strtoul(argv[3], NULL, 0) : WALL_SPAWN_PERIOD_MAX;
+
+    // Validate the whole library first
+    int errors = 0;
+    uint8_t i = 0;
+    for(; i < PATTERN_LIBRARY_SIZE; ++i) {
+        errors += validatePattern(i);
+    }
+    printf("%u patterns, %d errors\n", PATTERN_LIBRARY_SIZE, errors);
+    if(errors) {
+        return 1;
+    }
+
+    // Then run the engine the way the game loop does
+    Prng_t prng;
+    Prng_seed(&prng, seed);
+    PatternEngine_t engine;
+    Pattern_start(&engine, &prng, spawnPeriod);
+
+    uint32_t walls = 0;
+    uint32_t tick = 0;
+    for(; tick < ticks; ++tick) {
+        PatternWall_t wall;
+        if(Pattern_tick(&engine, spawnPeriod, &wall)) {
+            ++walls;
+            printf("tick %6u: wall", tick);
+            uint8_t gap = 0;
+            for(; gap < wall.numGaps; ++gap) {
+                printf(" %2u", wall.gap[gap]);
+            }
+            printf("\n");
+        }
+    }
+    printf("%u walls in %u ticks\n", walls, ticks);
+
+    return 0;
+}
+
+#endif /* HOST_BUILD */
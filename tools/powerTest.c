@@ -0,0 +1,143 @@
+/*
+ * powerTest.c
+ *
+ *  Created on: Dec 26, 2016
+ *      Author: boer8364
+ *
+ * Host unit test of the sleep and wake state machine: POWER_SLEEP_WHILE,
+ * the powerStats accounting and the host Hal_waitForInterrupt in LPM0 and
+ * LPM3, run against halHost's virtual clock. A scripted run of the screens
+ * and the game loop checks the number of wake-ups, the entries in each mode
+ * and the time spent asleep. Exits with 1 if a check fails:
+ *
+ *   make powerTest
+ *   ./powerTest
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include "hal.h"
+#include "power.h"
+#include "simClock.h"
+
+static uint32_t failures = 0;
+
+#define CHECK(condition) do { \
+        if(!(condition)) { \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while(0)
+
+// Number of times the sleep condition was checked
+static uint32_t checks;
+
+// Sleep condition of the game loop, counts its checks
+static uint8_t waitingForTicks(uint16_t ticks) {
+    ++checks;
+    return simTicksPending < ticks;
+}
+
+// Sleep condition of the screens, counts its checks
+static uint8_t waitingForButton() {
+    ++checks;
+    return !buttonPressed;
+}
+
+// A screen idling in LPM3, the button wakes it at once
+static void testDeepSleep() {
+    Power_resetStats();
+    uint32_t start = SimClock_now();
+    checks = 0;
+    Hal_buttonEnable();
+    POWER_SLEEP_WHILE(waitingForButton(), POWER_MODE_LPM3);
+    Hal_buttonDisable();
+
+    // One sleep, one wake-up and one more check that ends the wait
+    CHECK(checks == 2);
+    CHECK(powerStats.lpm3Entries == 1);
+    CHECK(powerStats.lpm0Entries == 0);
+    // The simulation clock is stopped in LPM3
+    CHECK(SimClock_now() == start);
+    CHECK(powerStats.sleepTime == 0);
+    CHECK(simTicksPending == 0);
+    CHECK(powerState == POWER_STATE_ACTIVE);
+}
+
+// The title screen idling in LPM0, the clock keeps counting until the press
+static void testTitleSleep() {
+    Power_resetStats();
+    uint32_t start = SimClock_now();
+    checks = 0;
+    Hal_buttonEnable();
+    POWER_SLEEP_WHILE(waitingForButton(), POWER_TITLE_MODE);
+    Hal_buttonDisable();
+
+    // The press comes with the first simulation tick
+    CHECK(checks == 2);
+    CHECK(powerStats.lpm0Entries == 1);
+    CHECK(powerStats.lpm3Entries == 0);
+    CHECK(SimClock_now() - start == SIM_TICK_PERIOD);
+    CHECK(powerStats.sleepTime == SIM_TICK_PERIOD);
+    CHECK(Power_getActiveTime() == 0);
+    CHECK(simTicksPending == 1);
+    CHECK(powerState == POWER_STATE_ACTIVE);
+}
+
+// The game loop pacing its frames on the simulation ticks
+static void testFramePacing() {
+    SimClock_reset();
+    Power_resetStats();
+    uint32_t start = SimClock_now();
+
+    // Each wake-up is one tick, the wait ends on the third
+    checks = 0;
+    POWER_SLEEP_WHILE(waitingForTicks(3), POWER_MODE_LPM0);
+    CHECK(checks == 4);
+    CHECK(simTicksPending == 3);
+    CHECK(powerStats.lpm0Entries == 3);
+    CHECK(powerStats.sleepTime == 3 * SIM_TICK_PERIOD);
+
+    // A condition that already fails does not sleep
+    checks = 0;
+    POWER_SLEEP_WHILE(waitingForTicks(3), POWER_MODE_LPM0);
+    CHECK(checks == 1);
+    CHECK(powerStats.lpm0Entries == 3);
+
+    // A scripted run of frames, each one waits for its tick
+    uint8_t frame = 0;
+    for(; frame < 10; ++frame) {
+        CHECK(SimClock_beginFrame() >= 1);
+        SimClock_endFrame(1);
+    }
+    // The first frame takes the 3 ticks already pending
+    CHECK(powerStats.lpm0Entries == 3 + 9);
+    CHECK(powerStats.lpm3Entries == 0);
+    CHECK(simClockStats.totalTicks == 3 + 9);
+    CHECK(SimClock_now() - start == (3 + 9) * SIM_TICK_PERIOD);
+    // Time only moves while asleep on the host
+    CHECK(powerStats.sleepTime == SimClock_now() - start);
+    CHECK(Power_getActiveTime() == 0);
+    CHECK(powerState == POWER_STATE_ACTIVE);
+}
+
+int main() {
+    Hal_init();
+    Hal_simTimerInit();
+
+    testDeepSleep();
+    testTitleSleep();
+    testFramePacing();
+    // An LPM3 sleep after the game loop leaves the clock where it was
+    testDeepSleep();
+
+    if(failures) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all power checks passed\n");
+    return 0;
+}
+
+#endif
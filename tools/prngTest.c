@@ -0,0 +1,125 @@
+/*
+ * prngTest.c
+ *
+ *  Created on: Dec 27, 2016
+ *      Author: boer8364
+ *
+ * Host unit test of the pseudo-random number generator in prng.h. The game
+ * seeds it from the simulation clock, so the seeds are small and close
+ * together, the test checks that the first wall gaps drawn from such seeds
+ * are spread over every gap position, and that the bounded numbers stay in
+ * range. Exits with 1 if a check fails:
+ *
+ *   make prngTest
+ *   ./prngTest
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include "prng.h"
+#include "wall.h"
+
+// Consecutive seeds checked, starting from 0
+#define PRNG_TEST_SEEDS 4096
+// First gaps of each seed checked
+#define PRNG_TEST_GAPS 2
+/* Smallest and largest share of the draws a gap position may get, as a
+ * fraction of the uniform share (128 draws per position here) */
+#define PRNG_TEST_MIN_SHARE 0.75
+#define PRNG_TEST_MAX_SHARE 1.25
+
+static uint32_t failures = 0;
+
+#define CHECK(condition) do { \
+        if(!(condition)) { \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while(0)
+
+// The first gaps of small seeds cover every position about evenly
+static void testFirstGaps() {
+    uint32_t histogram[PRNG_TEST_GAPS][WALL_ANGLE_GENERATION_RESOLUTION] =
+        {{0}};
+    uint32_t seed = 0;
+    for(; seed < PRNG_TEST_SEEDS; ++seed) {
+        Prng_t prng;
+        Prng_seed(&prng, seed);
+        uint8_t i = 0;
+        for(; i < PRNG_TEST_GAPS; ++i) {
+            ++histogram[i][Prng_nextBounded(&prng,
+                WALL_ANGLE_GENERATION_RESOLUTION)];
+        }
+    }
+
+    const double share = (double)PRNG_TEST_SEEDS /
+        WALL_ANGLE_GENERATION_RESOLUTION;
+    uint8_t i = 0;
+    for(; i < PRNG_TEST_GAPS; ++i) {
+        uint8_t gap = 0;
+        for(; gap < WALL_ANGLE_GENERATION_RESOLUTION; ++gap) {
+            if(histogram[i][gap] < share * PRNG_TEST_MIN_SHARE ||
+                histogram[i][gap] > share * PRNG_TEST_MAX_SHARE) {
+                printf("gap %u: position %u drawn %u times\n", i, gap,
+                    histogram[i][gap]);
+                ++failures;
+            }
+        }
+    }
+
+    // The first two gaps of seed 1 used to both be 0
+    Prng_t prng;
+    Prng_seed(&prng, 1);
+    uint32_t first = Prng_nextBounded(&prng, WALL_ANGLE_GENERATION_RESOLUTION);
+    uint32_t second = Prng_nextBounded(&prng,
+        WALL_ANGLE_GENERATION_RESOLUTION);
+    CHECK(first != 0 || second != 0);
+}
+
+// Same seed, same sequence, and 0 is a usable seed
+static void testSeeds() {
+    Prng_t a;
+    Prng_t b;
+    Prng_seed(&a, 12345);
+    Prng_seed(&b, 12345);
+    uint8_t i = 0;
+    for(; i < 16; ++i) {
+        CHECK(Prng_next(&a) == Prng_next(&b));
+    }
+
+    Prng_seed(&a, 0);
+    CHECK(a.state != 0);
+    Prng_seed(&b, 1);
+    CHECK(Prng_next(&a) != Prng_next(&b));
+}
+
+// Bounded numbers stay below their bound, including the biased bounds
+static void testBounds() {
+    const uint32_t bounds[] = {1, 2, 3, WALL_ANGLE_GENERATION_RESOLUTION, 1000,
+        0x80000001u, UINT32_MAX};
+    Prng_t prng;
+    Prng_seed(&prng, 7);
+    uint8_t b = 0;
+    for(; b < sizeof(bounds) / sizeof(bounds[0]); ++b) {
+        uint32_t i = 0;
+        for(; i < 1000; ++i) {
+            CHECK(Prng_nextBounded(&prng, bounds[b]) < bounds[b]);
+        }
+    }
+}
+
+int main() {
+    testFirstGaps();
+    testSeeds();
+    testBounds();
+
+    if(failures) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all prng checks passed\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * replayTool.c
+ *
+ *  Created on: Dec 19, 2016
+ *      Author: boer8364
+ *
+ * Host tool for input recordings (INPUT_REPLAY). Reads a recording, saved by
+ * the host build with HOST_RECORD or dumped from replayBuffer on the target
+ * with the debugger, and prints a summary of its games, every record with -v,
+ * or replayStream.c with the recording built in with -c:
+ *
+ *   make replayTool
+ *   ./replayTool [-v | -c] run.rec
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "replay.h"
+
+// Output format
+static enum {
+    OUTPUT_SUMMARY,
+    OUTPUT_VERBOSE,
+    OUTPUT_SOURCE
+} output = OUTPUT_SUMMARY;
+
+static uint8_t stream[REPLAY_BUFFER_SIZE];
+static uint32_t length;
+static uint32_t position = 0;
+
+// Reads the next byte, returns 0 past the end
+static uint8_t readByte() {
+    return position < length ? stream[position++] : 0;
+}
+
+static uint32_t read32() {
+    uint32_t value = readByte();
+    value |= (uint32_t)readByte() << 8;
+    value |= (uint32_t)readByte() << 16;
+    value |= (uint32_t)readByte() << 24;
+    return value;
+}
+
+static int32_t readVarint() {
+    uint32_t zigzag = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        byte = readByte();
+        zigzag |= (uint32_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while((byte & 0x80) && shift < 32);
+    return (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+}
+
+// Prints the recording as the contents of replayStream.c
+static void printSource() {
+    printf("/*\n * replayStream.c\n *\n *  Generated by tools/replayTool.c\n"
+        " */\n\n#include \"globalMacros.h\"\n\n"
+        "#if defined(INPUT_REPLAY) && !defined(HOST_BUILD)\n\n"
+        "#include \"replay.h\"\n\nconst uint8_t replayStream[] = {");
+    uint32_t i = 0;
+    for(; i < length; ++i) {
+        printf("%s0x%02x", i % 12 ? ", " : (i ? ",\n    " : "\n    "),
+            stream[i]);
+    }
+    printf("\n};\nconst uint32_t replayStreamLength = %u;\n\n#endif\n",
+        length);
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    int i = 1;
+    for(; i < argc; ++i) {
+        if(!strcmp(argv[i], "-v")) {
+            output = OUTPUT_VERBOSE;
+        } else if(!strcmp(argv[i], "-c")) {
+            output = OUTPUT_SOURCE;
+        } else {
+            path = argv[i];
+        }
+    }
+    if(!path) {
+        fprintf(stderr, "usage: %s [-v | -c] recording\n", argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if(!file) {
+        fprintf(stderr, "Can not open %s\n", path);
+        return 1;
+    }
+    length = (uint32_t)fread(stream, 1, sizeof(stream), file);
+    fclose(file);
+
+    // Drop the end record and anything after it
+    uint32_t end = 0;
+    while(end < length) {
+        uint8_t tag = stream[end];
+        if(tag == REPLAY_RECORD_END) {
+            break;
+        }
+        position = end + 1;
+        switch(tag) {
+        case REPLAY_RECORD_GAME_START:
+            position += 4;
+            break;
+        case REPLAY_RECORD_GAME_OVER:
+            position += 8;
+            break;
+        case REPLAY_RECORD_READING:
+            readVarint();
+            readVarint();
+            break;
+        case REPLAY_RECORD_REPEAT:
+            ++position;
+            break;
+        case REPLAY_RECORD_BUTTON:
+            break;
+        default:
+            fprintf(stderr, "Unknown record 0x%02x at %u\n", tag, end);
+            return 1;
+        }
+        end = position;
+    }
+    length = end;
+
+    if(output == OUTPUT_SOURCE) {
+        printSource();
+        return 0;
+    }
+
+    uint32_t games = 0;
+    uint32_t totalTicks = 0;
+    uint32_t gameTicks = 0;
+    uint32_t gameStart = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+    position = 0;
+    while(position < length) {
+        uint32_t recordStart = position;
+        switch(readByte()) {
+        case REPLAY_RECORD_GAME_START: {
+            uint32_t seed = read32();
+            ++games;
+            gameTicks = 0;
+            gameStart = recordStart;
+            x = 0;
+            y = 0;
+            if(output == OUTPUT_VERBOSE) {
+                printf("%u: game start, seed 0x%08x\n", recordStart, seed);
+            }
+            break;
+        }
+        case REPLAY_RECORD_READING:
+            x += readVarint();
+            y += readVarint();
+            ++gameTicks;
+            if(output == OUTPUT_VERBOSE) {
+                printf("%u: tick %u, x %d y %d\n", recordStart, gameTicks, x,
+                    y);
+            }
+            break;
+        case REPLAY_RECORD_REPEAT: {
+            uint8_t count = readByte();
+            gameTicks += count;
+            if(output == OUTPUT_VERBOSE) {
+                printf("%u: repeat x %d y %d for %u ticks\n", recordStart, x,
+                    y, count);
+            }
+            break;
+        }
+        case REPLAY_RECORD_BUTTON:
+            if(output == OUTPUT_VERBOSE) {
+                printf("%u: button\n", recordStart);
+            }
+            break;
+        case REPLAY_RECORD_GAME_OVER: {
+            uint32_t ticks = read32();
+            uint32_t checksum = read32();
+            totalTicks += gameTicks;
+            printf("game %u: %u ticks (%u recorded), checksum 0x%08x, "
+                "%.2f bytes per tick\n", games, ticks, gameTicks, checksum,
+                gameTicks ? (double)(position - gameStart) / gameTicks : 0.0);
+            break;
+        }
+        }
+    }
+    printf("%u games, %u ticks, %u bytes\n", games, totalTicks, length);
+    return 0;
+}
+
+#endif
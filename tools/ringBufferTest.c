@@ -0,0 +1,409 @@
+/*
+ * ringBufferTest.c
+ *
+ *  Created on: Dec 24, 2016
+ *      Author: boer8364
+ *
+ * Host unit test and throughput benchmark of the ring buffer template in
+ * ringBuffer.h and of the WallBuffer built on it. The tests cover push and
+ * pop, full and empty, the contiguous spans, the free-running indices
+ * wrapping around 2^32, and snapshots taken while a producer thread keeps
+ * pushing. The benchmark times the template and WallBuffer against the
+ * queue they replaced, which wrapped its indices with % bufferSize into a
+ * 10 slot array of whole walls. Exits with 1 if a check fails:
+ *
+ *   make ringBufferTest
+ *   ./ringBufferTest [-bench]
+ */
+
+#ifdef HOST_BUILD
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ringBuffer.h"
+#include "wallBuffer.h"
+
+RING_BUFFER_DECLARE(TestBuffer, uint32_t, 3)
+
+#define TEST_CAPACITY RING_BUFFER_CAPACITY(3)
+
+// Items the producer thread pushes through the buffer
+#define THREADED_ITEMS 2000000
+// Rounds of each benchmark
+#define BENCH_ROUNDS 2000000
+
+static uint32_t failures = 0;
+
+#define CHECK(condition) do { \
+        if(!(condition)) { \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while(0)
+
+static TestBuffer_t buffer;
+
+// Sets both indices to start, as if start items had passed through already
+static void startAt(uint32_t start) {
+    TestBuffer_init(&buffer);
+    buffer.index.head = start;
+    buffer.index.tail = start;
+}
+
+static void testPushPop(uint32_t start) {
+    startAt(start);
+    uint32_t item;
+    CHECK(TestBuffer_count(&buffer) == 0);
+    CHECK(TestBuffer_space(&buffer) == TEST_CAPACITY);
+    CHECK(!TestBuffer_pop(&buffer, &item));
+
+    // Fill it up, the whole capacity is usable
+    uint32_t i = 0;
+    for(; i < TEST_CAPACITY; ++i) {
+        CHECK(TestBuffer_push(&buffer, &i));
+    }
+    CHECK(TestBuffer_count(&buffer) == TEST_CAPACITY);
+    CHECK(TestBuffer_space(&buffer) == 0);
+    CHECK(!TestBuffer_push(&buffer, &i));
+    CHECK(TestBuffer_headSlot(&buffer) == NULL);
+
+    // Items come out in order
+    for(i = 0; i < TEST_CAPACITY; ++i) {
+        CHECK(TestBuffer_pop(&buffer, &item) && item == i);
+    }
+    CHECK(!TestBuffer_pop(&buffer, &item));
+
+    // Many times around the array, with a varying fill level
+    uint32_t next = 0;
+    uint32_t expected = 0;
+    uint32_t round = 0;
+    for(; round < 100; ++round) {
+        uint32_t pushes = round % (TEST_CAPACITY + 1);
+        for(i = 0; i < pushes; ++i, ++next) {
+            CHECK(TestBuffer_push(&buffer, &next));
+        }
+        while(TestBuffer_pop(&buffer, &item)) {
+            CHECK(item == expected);
+            ++expected;
+        }
+    }
+    CHECK(expected == next);
+    CHECK(buffer.index.head == start + TEST_CAPACITY + next);
+}
+
+static void testSpans(uint32_t start) {
+    startAt(start);
+    uint32_t written = 0;
+    uint32_t read = 0;
+    uint32_t round = 0;
+    for(; round < 50; ++round) {
+        // Write what fits, in at most two spans
+        uint32_t length;
+        uint32_t* span = TestBuffer_contiguousWrite(&buffer, &length);
+        CHECK(length <= TestBuffer_space(&buffer));
+        uint32_t i = 0;
+        for(; i < length && i < 3; ++i) {
+            span[i] = written++;
+        }
+        TestBuffer_publish(&buffer, i);
+
+        // Read back one span
+        span = TestBuffer_contiguousRead(&buffer, &length);
+        CHECK(length <= TestBuffer_count(&buffer));
+        for(i = 0; i < length && i < 2; ++i) {
+            CHECK(span[i] == read);
+            ++read;
+        }
+        TestBuffer_drop(&buffer, i);
+    }
+    TestBuffer_clear(&buffer);
+    CHECK(TestBuffer_count(&buffer) == 0);
+}
+
+static void testSnapshot(uint32_t start) {
+    startAt(start);
+    uint32_t i = 0;
+    for(; i < 5; ++i) {
+        TestBuffer_push(&buffer, &i);
+    }
+    TestBufferSnapshot_t snapshot;
+    TestBuffer_takeSnapshot(&buffer, &snapshot);
+    // Items pushed later do not show up in an earlier snapshot
+    uint32_t more = 5;
+    TestBuffer_push(&buffer, &more);
+    CHECK(snapshot.numItems == 5);
+    for(i = 0; i < snapshot.numItems; ++i) {
+        CHECK(*TestBuffer_snapshotItem(&snapshot, i) == i);
+    }
+    TestBuffer_drop(&buffer, snapshot.numItems);
+    CHECK(TestBuffer_count(&buffer) == 1);
+}
+
+static void testWallBuffer(uint32_t start) {
+    static WallBuffer_t walls;
+    WallBuffer_init(&walls);
+    walls.index.head = start;
+    walls.index.tail = start;
+
+    WallAngle_t gaps[WALL_MAX_GAPS] = {0, 16384};
+    uint32_t i = 0;
+    for(; i < WALL_BUFFER_SIZE; ++i) {
+        gaps[0] = (WallAngle_t)i;
+        CHECK(WallBuffer_addWall(&walls, gaps, 2) == WALL_BUFFER_NO_ERROR);
+        WallBuffer_advanceTick(&walls);
+    }
+    CHECK(WallBuffer_addWall(&walls, gaps, 1) == WALL_BUFFER_OVERFLOW);
+
+    // The oldest wall is the inner-most one
+    WallBufferSnapshot_t snapshot;
+    WallBuffer_takeSnapshot(&walls, &snapshot);
+    CHECK(snapshot.numItems == WALL_BUFFER_SIZE);
+    for(i = 0; i < snapshot.numItems; ++i) {
+        Wall_t wall;
+        WallBuffer_getSnapshotWall(&snapshot, i, &wall);
+        CHECK(wall.numGaps == 2);
+        CHECK(wall.gapStartAngle[0] == WALL_ANGLE_TO_RADIANS(i));
+        CHECK(wall.radius == WALL_INITIAL_RADIUS -
+            (int16_t)(WALL_BUFFER_SIZE - i) * WALL_SPEED);
+    }
+
+    for(i = 0; i < WALL_BUFFER_SIZE; ++i) {
+        CHECK(WallBuffer_removeWall(&walls) == WALL_BUFFER_NO_ERROR);
+    }
+    CHECK(WallBuffer_removeWall(&walls) == WALL_BUFFER_UNDERFLOW);
+    WallBuffer_addWall(&walls, gaps, 1);
+    WallBuffer_emptyBuffer(&walls);
+    WallBuffer_takeSnapshot(&walls, &snapshot);
+    CHECK(snapshot.numItems == 0);
+}
+
+/* ***** Producer thread against a consumer that pops and snapshots ***** */
+
+static void* producer(void* argument) {
+    (void)argument;
+    uint32_t i = 0;
+    while(i < THREADED_ITEMS) {
+        if(TestBuffer_push(&buffer, &i)) {
+            ++i;
+        } else {
+            // Let the consumer run, on a single core it would wait a slice
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void testThreaded(uint32_t start) {
+    startAt(start);
+    pthread_t thread;
+    pthread_create(&thread, NULL, producer, NULL);
+
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    while(expected < THREADED_ITEMS) {
+        if(expected & 1) {
+            // Every item a snapshot covers was fully written
+            TestBufferSnapshot_t snapshot;
+            TestBuffer_takeSnapshot(&buffer, &snapshot);
+            uint32_t i = 0;
+            for(; i < snapshot.numItems; ++i) {
+                errors += *TestBuffer_snapshotItem(&snapshot, i) !=
+                    expected + i;
+            }
+            TestBuffer_drop(&buffer, snapshot.numItems);
+            expected += snapshot.numItems;
+            if(!snapshot.numItems) {
+                sched_yield();
+            }
+        } else {
+            uint32_t item;
+            if(TestBuffer_pop(&buffer, &item)) {
+                errors += item != expected;
+                ++expected;
+            } else {
+                sched_yield();
+            }
+        }
+    }
+    pthread_join(thread, NULL);
+    CHECK(errors == 0);
+    CHECK(TestBuffer_count(&buffer) == 0);
+}
+
+/* ***** Benchmark ***** */
+
+/* The queue the template replaced, the size is only known at run time so
+ * every index is wrapped with a division */
+typedef struct ModuloBuffer {
+    uint32_t data[WALL_BUFFER_SIZE];
+    uint32_t bufferSize;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} ModuloBuffer_t;
+
+static uint8_t ModuloBuffer_push(ModuloBuffer_t* self, uint32_t item) {
+    uint32_t head = self->head;
+    if(head - self->tail >= self->bufferSize) {
+        return 0;
+    }
+    self->data[head % self->bufferSize] = item;
+    MEMORY_BARRIER();
+    self->head = head + 1;
+    return 1;
+}
+
+static uint8_t ModuloBuffer_pop(ModuloBuffer_t* self, uint32_t* item) {
+    uint32_t tail = self->tail;
+    if(self->head == tail) {
+        return 0;
+    }
+    MEMORY_BARRIER();
+    *item = self->data[tail % self->bufferSize];
+    MEMORY_BARRIER();
+    self->tail = tail + 1;
+    return 1;
+}
+
+/* The wall buffer the template replaced, whole walls in a 10 slot array,
+ * every live wall's radius is decremented on each tick */
+typedef struct OldWallBuffer {
+    Wall_t buffer[10];
+    uint32_t bufferSize;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} OldWallBuffer_t;
+
+// What Wall_init did for a new wall with a single gap
+static void initOldWall(Wall_t* wall) {
+    wall->gapStartAngle[0] = 0.0;
+    wall->gapEndAngle[0] = 0.6;
+    wall->numGaps = 1;
+    wall->radius = WALL_INITIAL_RADIUS;
+}
+
+// Keeps the benchmarked work from being optimized away
+static volatile uint32_t sink;
+
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static void report(const char* name, double seconds) {
+    printf("%-28s %8.2f ns per round\n", name, seconds * 1e9 / BENCH_ROUNDS);
+}
+
+static void bench() {
+    // A push and a pop per round, with a few items in flight
+    static ModuloBuffer_t modulo;
+    modulo.bufferSize = 10;
+    modulo.head = modulo.tail = 0;
+    uint32_t sum = 0;
+    uint32_t item = 0;
+    uint32_t i = 0;
+    for(; i < 4; ++i) {
+        ModuloBuffer_push(&modulo, i);
+    }
+    double start = now();
+    for(i = 0; i < BENCH_ROUNDS; ++i) {
+        ModuloBuffer_push(&modulo, i);
+        ModuloBuffer_pop(&modulo, &item);
+        sum += item;
+    }
+    report("% bufferSize push/pop", now() - start);
+
+    startAt(0);
+    for(i = 0; i < 4; ++i) {
+        TestBuffer_push(&buffer, &i);
+    }
+    start = now();
+    for(i = 0; i < BENCH_ROUNDS; ++i) {
+        TestBuffer_push(&buffer, &i);
+        TestBuffer_pop(&buffer, &item);
+        sum += item;
+    }
+    report("template push/pop", now() - start);
+
+    /* A game tick with 8 live walls: close them in, walk them as the draw
+     * and collision code do, and replace the inner-most one */
+    static OldWallBuffer_t oldWalls;
+    oldWalls.bufferSize = 10;
+    oldWalls.head = oldWalls.tail = 0;
+    for(i = 0; i < 8; ++i) {
+        initOldWall(&oldWalls.buffer[oldWalls.head++ % 10]);
+    }
+    start = now();
+    for(i = 0; i < BENCH_ROUNDS; ++i) {
+        uint32_t tail = oldWalls.tail;
+        uint32_t count = oldWalls.head - tail;
+        uint32_t j = 0;
+        for(; j < count; ++j) {
+            oldWalls.buffer[(tail + j) % oldWalls.bufferSize].radius -=
+                WALL_SPEED;
+        }
+        for(j = 0; j < count; ++j) {
+            Wall_t* wall = &oldWalls.buffer[(tail + j) % oldWalls.bufferSize];
+            sum += wall->radius + (uint32_t)wall->gapStartAngle[0];
+        }
+        MEMORY_BARRIER();
+        oldWalls.tail = tail + 1;
+        initOldWall(&oldWalls.buffer[oldWalls.head % oldWalls.bufferSize]);
+        MEMORY_BARRIER();
+        oldWalls.head = oldWalls.head + 1;
+    }
+    report("% bufferSize wall tick", now() - start);
+
+    static WallBuffer_t walls;
+    WallBuffer_init(&walls);
+    WallAngle_t gaps[WALL_MAX_GAPS] = {0, 16384};
+    for(i = 0; i < 8; ++i) {
+        WallBuffer_addWall(&walls, gaps, 1);
+    }
+    start = now();
+    for(i = 0; i < BENCH_ROUNDS; ++i) {
+        WallBuffer_advanceTick(&walls);
+        WallBufferSnapshot_t snapshot;
+        WallBuffer_takeSnapshot(&walls, &snapshot);
+        uint32_t j = 0;
+        for(; j < snapshot.numItems; ++j) {
+            Wall_t wall;
+            WallBuffer_getSnapshotWall(&snapshot, j, &wall);
+            sum += wall.radius + (uint32_t)wall.gapStartAngle[0];
+        }
+        WallBuffer_removeWall(&walls);
+        WallBuffer_addWall(&walls, gaps, 1);
+    }
+    report("WallBuffer wall tick", now() - start);
+    sink = sum;
+}
+
+int main(int argc, char** argv) {
+    // Around zero, and across the 2^32 wrap of the free-running indices
+    const uint32_t starts[] = {0, UINT32_MAX - TEST_CAPACITY / 2,
+        UINT32_MAX - 3 * TEST_CAPACITY};
+    uint8_t s = 0;
+    for(; s < sizeof(starts) / sizeof(starts[0]); ++s) {
+        testPushPop(starts[s]);
+        testSpans(starts[s]);
+        testSnapshot(starts[s]);
+        testWallBuffer(starts[s]);
+    }
+    testThreaded(UINT32_MAX - THREADED_ITEMS / 2);
+
+    if(failures) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all ring buffer checks passed\n");
+
+    if(argc > 1 && !strcmp(argv[1], "-bench")) {
+        bench();
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,215 @@
+/*
+ * traceDecode.c
+ *
+ *  Created on: Dec 16, 2016
+ *      Author: boer8364
+ *
+ * Host decoder for the binary event trace (TRACE_DEBUG). Reads a captured
+ * UART stream, which may mix trace records with ASCII log text, and prints
+ * the events as text, or as Chrome trace JSON with -json, which loads in
+ * chrome://tracing and ui.perfetto.dev. The timestamps resync on the clock
+ * records, the exit code is 1 if one disagrees with the time extended from
+ * the records before it. The host game captures a trace with:
+ *
+ *   make hostGameTrace traceDecode
+ *   HOST_UART=capture.bin ./hostGameTrace
+ *   ./traceDecode [-json] capture.bin > trace.json
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include "trace.h"
+#include "simClock.h"
+
+static const char* const EVENT_NAMES[TRACE_EVENT_COUNT] = {
+    "unknown",
+    "game start",
+    "game over",
+    "frame start",
+    "frame end",
+    "tick",
+    "wall spawn",
+    "wall despawn",
+    "collision",
+    "adc sample",
+    "log",
+    "clock"
+};
+
+// Output format
+static int json = 0;
+// Separates the JSON events
+static const char* jsonSeparator = "";
+
+// Prints the payload of an event in a readable form
+static void printPayload(uint8_t event, int32_t payload) {
+    switch(event) {
+    case TRACE_EVENT_WALL_SPAWN: {
+        uint8_t numGaps = (uint32_t)payload >> 24;
+        printf("gaps");
+        uint8_t i = 0;
+        for(; i < numGaps && i < 3; ++i) {
+            printf(" %u", (payload >> (8 * i)) & 0xff);
+        }
+        break;
+    }
+    case TRACE_EVENT_COLLISION:
+        printf("%s", payload == 1 ? "wall" : payload == 2 ? "gap" : "none");
+        break;
+    case TRACE_EVENT_ADC_SAMPLE:
+        printf("x %d y %d", (int16_t)(payload >> 16), (int16_t)payload);
+        break;
+    default:
+        printf("%d", payload);
+        break;
+    }
+}
+
+static void printText(double microseconds, uint8_t event, int32_t payload) {
+    printf("%12.1f us  %-12s ", microseconds,
+        event < TRACE_EVENT_COUNT ? EVENT_NAMES[event] : "unknown");
+    printPayload(event, payload);
+    printf("\n");
+}
+
+static void printJson(double microseconds, uint8_t event, int32_t payload) {
+    const char* name = event < TRACE_EVENT_COUNT ?
+        EVENT_NAMES[event] : "unknown";
+    printf("%s\n  {\"pid\": 1, \"tid\": 1, \"ts\": %.1f, ", jsonSeparator,
+        microseconds);
+    jsonSeparator = ",";
+
+    switch(event) {
+    case TRACE_EVENT_FRAME_START:
+        // Frames show up as slices on the timeline
+        printf("\"ph\": \"B\", \"name\": \"frame\", "
+            "\"args\": {\"ticks\": %d}}", payload);
+        break;
+    case TRACE_EVENT_FRAME_END:
+        printf("\"ph\": \"E\", \"name\": \"frame\", "
+            "\"args\": {\"rendered\": %d}}", payload);
+        break;
+    case TRACE_EVENT_ADC_SAMPLE:
+        // The readings show up as a counter track
+        printf("\"ph\": \"C\", \"name\": \"accelerometer\", "
+            "\"args\": {\"x\": %d, \"y\": %d}}", (int16_t)(payload >> 16),
+            (int16_t)payload);
+        break;
+    default:
+        printf("\"ph\": \"i\", \"s\": \"t\", \"name\": \"%s\", "
+            "\"args\": {\"payload\": \"", name);
+        printPayload(event, payload);
+        printf("\"}}");
+        break;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    int i = 1;
+    for(; i < argc; ++i) {
+        if(strcmp(argv[i], "-json") == 0) {
+            json = 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    FILE* capture = path ? fopen(path, "rb") : stdin;
+    if(!capture) {
+        perror(path);
+        return 1;
+    }
+
+    if(json) {
+        printf("{\"traceEvents\": [");
+    }
+
+    // Extended timestamp and the last 16-bit timestamp seen
+    uint64_t timestamp = 0;
+    uint16_t lastLow = 0;
+    int haveTimestamp = 0;
+    // Log text between records
+    char text[256];
+    size_t textLength = 0;
+    uint32_t records = 0;
+    // Clock records the extended timestamp did not match
+    uint32_t clockErrors = 0;
+
+    int byte;
+    while((byte = fgetc(capture)) != EOF) {
+        if(byte != TRACE_SYNC) {
+            // Log text, passed through in text mode, one line at a time
+            if(!json && (byte == '\r' || byte == '\n' ||
+                textLength == sizeof(text) - 1)) {
+                if(textLength) {
+                    printf("%12s  log          %.*s\n", "", (int)textLength,
+                        text);
+                }
+                textLength = 0;
+            } else if(byte >= ' ' && byte < 0x7f) {
+                text[textLength++] = (char)byte;
+            }
+            continue;
+        }
+
+        uint8_t record[TRACE_RECORD_SIZE];
+        record[0] = TRACE_SYNC;
+        if(fread(record + 1, 1, TRACE_RECORD_SIZE - 1, capture) !=
+            TRACE_RECORD_SIZE - 1) {
+            fprintf(stderr, "truncated record at the end of the capture\n");
+            break;
+        }
+
+        uint8_t event = record[1];
+        uint16_t low = (uint16_t)(record[2] | (record[3] << 8));
+        int32_t payload = (int32_t)((uint32_t)record[4] |
+            ((uint32_t)record[5] << 8) | ((uint32_t)record[6] << 16) |
+            ((uint32_t)record[7] << 24));
+
+        // Extend the timestamp, the 16-bit count wraps every two seconds
+        if(haveTimestamp) {
+            timestamp += (uint16_t)(low - lastLow);
+        } else {
+            timestamp = low;
+        }
+        lastLow = low;
+        if(event == TRACE_EVENT_CLOCK) {
+            // The clock record carries the whole clock, it wraps in 36 hours
+            uint32_t clock = (uint32_t)payload;
+            if(haveTimestamp && (uint32_t)timestamp != clock) {
+                fprintf(stderr, "clock %u, extended timestamp was %u\n",
+                    clock, (uint32_t)timestamp);
+                ++clockErrors;
+            }
+            timestamp = (timestamp & ~(uint64_t)UINT32_MAX) | clock;
+            haveTimestamp = 1;
+            if(json) {
+                continue;
+            }
+        }
+        haveTimestamp = 1;
+
+        double microseconds = (double)timestamp * 1e6 / SIM_CLOCK_FREQUENCY;
+        if(json) {
+            printJson(microseconds, event, payload);
+        } else {
+            printText(microseconds, event, payload);
+        }
+        ++records;
+    }
+
+    if(json) {
+        printf("\n]}\n");
+    }
+    fprintf(stderr, "%u records\n", records);
+
+    if(capture != stdin) {
+        fclose(capture);
+    }
+    return clockErrors > 0;
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,69 @@
+/*
+ * trace.c
+ *
+ *  Created on: Dec 16, 2016
+ *      Author: boer8364
+ */
+
+#include "trace.h"
+
+#if defined(TRACE_DEBUG) || defined(TRACE_RAM)
+
+#include <stddef.h>
+#include "simClock.h"
+
+#ifdef TRACE_RAM
+TraceRamRecord_t traceRamBuffer[TRACE_RAM_SIZE];
+uint32_t traceRamCount = 0;
+
+static void record(TraceEvent_t event, int32_t payload, const char* message) {
+    TraceRamRecord_t* slot =
+        &traceRamBuffer[traceRamCount & (TRACE_RAM_SIZE - 1)];
+    slot->message = message;
+    slot->payload = payload;
+    slot->timestamp = (uint16_t)SimClock_now();
+    slot->event = (uint8_t)event;
+    ++traceRamCount;
+}
+
+void Trace_log(const char* message, int32_t payload) {
+    record(TRACE_EVENT_LOG, payload, message);
+}
+
+void Trace_event(TraceEvent_t event, int32_t payload) {
+    record(event, payload, NULL);
+}
+#else
+#include "uartLogger.h"
+
+// Time of the last clock record, none has gone out at startup
+static uint32_t lastClockTime;
+static uint8_t clockSent = 0;
+
+static void send(TraceEvent_t event, uint32_t now, int32_t payload) {
+    uint16_t timestamp = (uint16_t)now;
+    uint8_t record[TRACE_RECORD_SIZE] = {
+        TRACE_SYNC,
+        (uint8_t)event,
+        (uint8_t)timestamp,
+        (uint8_t)(timestamp >> 8),
+        (uint8_t)payload,
+        (uint8_t)(payload >> 8),
+        (uint8_t)(payload >> 16),
+        (uint8_t)(payload >> 24)
+    };
+    UART_Logger_sendRecord(record, TRACE_RECORD_SIZE);
+}
+
+void Trace_event(TraceEvent_t event, int32_t payload) {
+    uint32_t now = SimClock_now();
+    if(!clockSent || now - lastClockTime >= TRACE_CLOCK_PERIOD) {
+        send(TRACE_EVENT_CLOCK, now, (int32_t)now);
+        lastClockTime = now;
+        clockSent = 1;
+    }
+    send(event, now, payload);
+}
+#endif
+
+#endif
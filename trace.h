@@ -0,0 +1,98 @@
+/*
+ * trace.h
+ *
+ *  Created on: Dec 16, 2016
+ *      Author: boer8364
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <inttypes.h>
+#include "globalMacros.h"
+
+/* Trace records are fixed-size and sent through the UART logger unformatted:
+ *
+ *   byte 0     TRACE_SYNC, it has the high bit set so it never shows up in
+ *              ASCII log text and the decoder can find records in a mixed
+ *              stream
+ *   byte 1     event id
+ *   bytes 2-3  low 16 bits of the simulation clock (ACLK cycles), little
+ *              endian, the decoder extends it from the record before
+ *   bytes 4-7  payload, little endian
+ *
+ * The 16 bits wrap every two seconds, and the clock keeps running on the
+ * title screen, so a clock record with the whole simulation clock goes out
+ * ahead of any record sent TRACE_CLOCK_PERIOD or more after the last one, and
+ * the decoder resyncs on it */
+#define TRACE_SYNC 0xa5
+#define TRACE_RECORD_SIZE 8
+// Longest time between clock records in ACLK cycles, one second
+#define TRACE_CLOCK_PERIOD 32768u
+
+// Event ids
+typedef enum TraceEvent {
+    // A game started, payload is the PRNG seed
+    TRACE_EVENT_GAME_START = 1,
+    // The player lost, payload is the number of ticks played
+    TRACE_EVENT_GAME_OVER,
+    // The game loop started a frame, payload is the ticks it will simulate
+    TRACE_EVENT_FRAME_START,
+    // The game loop finished a frame, payload is 1 if it was rendered
+    TRACE_EVENT_FRAME_END,
+    // A simulation tick started, payload is the wall buffer tick
+    TRACE_EVENT_TICK,
+    /* A wall spawned, payload is the number of gaps in the top byte and the
+     * gap positions in the low bytes */
+    TRACE_EVENT_WALL_SPAWN,
+    // The player passed a wall, payload is the number of walls left
+    TRACE_EVENT_WALL_DESPAWN,
+    // The player touched a wall, payload is the collision code
+    TRACE_EVENT_COLLISION,
+    /* Accelerometer reading, payload is x in the high half and y in the low
+     * half */
+    TRACE_EVENT_ADC_SAMPLE,
+    // Log message, only recorded in the RAM trace, payload is the value
+    TRACE_EVENT_LOG,
+    // Resync of the timestamps, payload is the whole simulation clock
+    TRACE_EVENT_CLOCK,
+    // Number of event ids, not an event
+    TRACE_EVENT_COUNT
+} TraceEvent_t;
+
+#ifdef TRACE_RAM
+/* The RAM trace is a flight recorder: the last TRACE_RAM_SIZE records are
+ * kept in traceRamBuffer, overwriting the oldest, for the debugger to read
+ * out, it never touches the UART */
+#define TRACE_RAM_SIZE_LOG2 6
+#define TRACE_RAM_SIZE (1 << TRACE_RAM_SIZE_LOG2)
+
+typedef struct TraceRamRecord {
+    // Message of a log record, NULL for other events
+    const char* message;
+    int32_t payload;
+    uint16_t timestamp;
+    uint8_t event;
+} TraceRamRecord_t;
+
+extern TraceRamRecord_t traceRamBuffer[TRACE_RAM_SIZE];
+/* Number of records ever written, the newest one is at
+ * (traceRamCount - 1) % TRACE_RAM_SIZE */
+extern uint32_t traceRamCount;
+
+// Records a log message and its value
+void Trace_log(const char* message, int32_t payload);
+#endif
+
+#if defined(TRACE_DEBUG) || defined(TRACE_RAM)
+/* Records an event, into the RAM trace with TRACE_RAM, otherwise as a record
+ * over the UART, which is dropped whole if it does not fit */
+void Trace_event(TraceEvent_t event, int32_t payload);
+
+#define TRACE_EVENT(event, payload) Trace_event((event), (int32_t)(payload))
+#else
+// The payload is not evaluated when tracing is compiled out
+#define TRACE_EVENT(event, payload) ((void)0)
+#endif
+
+#endif /* TRACE_H_ */
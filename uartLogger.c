@@ -7,38 +7,37 @@
 
 
 #include "uartLogger.h"
-#include <math.h>
 
 #ifdef UART_DEBUG
 
+#include "power.h"
+
+UartLoggerBuffer_t uartLoggerBuffer;
+volatile uint32_t uartLoggerDroppedBytes = 0;
+
 static void numToString(int32_t num, char* str) {
-    unsigned int i = 0;
+    /* Work on the magnitude as an unsigned number, so that INT32_MIN does not
+     * overflow when it is negated */
+    uint32_t magnitude = num < 0 ? -(uint32_t)num : (uint32_t)num;
 
-    // Flag set if num is negative
-    uint8_t neg = 0;
-    // This code only works for positive numbers
+    // Compute the digits, least significant first
+    char digits[10];
+    unsigned int digitCount = 0;
+    do {
+        digits[digitCount++] = magnitude % 10 + '0';
+        magnitude /= 10;
+    } while(magnitude > 0);
+
+    // Copy the digits out in the right order after the sign
+    unsigned int i = 0;
     if(num < 0) {
-        str[0] = '-';
-        neg = 1;
-        num = -num;
-    } else if(num == 0) {
-        // If the number is 0, set the string and exit immediately
-        str[0] = '0';
-        str[1] = '\0';
-        return;
+        str[i++] = '-';
     }
-
-    // Find the number of digits in this number
-    int digitCount = ((int)log10(num)) + 1;
-
-    // Loop through to compute the digits
-    while(num > 0) {
-        str[digitCount - i - 1 + neg] = num % 10 + '0';
-        num /= 10;
-        ++i;
+    while(digitCount > 0) {
+        str[i++] = digits[--digitCount];
     }
     // Terminate the string
-    str[i + neg] = '\0';
+    str[i] = '\0';
 }
 
 void UART_Logger_sendBytes(uint8_t* byteArray, unsigned int length) {
@@ -58,10 +57,51 @@ void UART_Logger_sendString(const char* str) {
 }
 
 void UART_Logger_sendNumSigned(int32_t num) {
-    // Convert the number to a string and send it
-    char numStr[6];
+    // Convert the number to a string and send it, big enough for INT32_MIN
+    char numStr[12];
     numToString(num, numStr);
     UART_Logger_sendString(numStr);
 }
 
+void UART_Logger_sendRecord(const uint8_t* record, unsigned int length) {
+    if(UartLoggerBuffer_space(&uartLoggerBuffer) < length) {
+        uartLoggerDroppedBytes += length;
+        return;
+    }
+    unsigned int i;
+    for(i = 0; i < length; ++i) {
+        UART_Logger_sendByte(record[i]);
+    }
+}
+
+void UART_Logger_flush() {
+    POWER_SLEEP_WHILE(UartLoggerBuffer_count(&uartLoggerBuffer) > 0,
+        POWER_MODE_LPM0);
+}
+
+#ifdef HOST_BUILD
+uint8_t uartLoggerHostCapture[UART_LOGGER_HOST_CAPTURE_SIZE];
+uint32_t uartLoggerHostCaptureLength = 0;
+
+uint32_t UART_Logger_hostTransmit(uint32_t maxBytes) {
+    uint32_t sent = 0;
+    uint8_t byte;
+    while(sent < maxBytes &&
+        UartLoggerBuffer_pop(&uartLoggerBuffer, &byte)) {
+        // A full capture keeps the oldest bytes
+        if(uartLoggerHostCaptureLength < UART_LOGGER_HOST_CAPTURE_SIZE) {
+            uartLoggerHostCapture[uartLoggerHostCaptureLength++] = byte;
+        }
+        ++sent;
+    }
+    return sent;
+}
+
+void UART_Logger_hostReset() {
+    UartLoggerBuffer_init(&uartLoggerBuffer);
+    uartLoggerHostCaptureLength = 0;
+    uartLoggerDroppedBytes = 0;
+}
+#endif
+
 #endif
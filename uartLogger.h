@@ -12,7 +12,21 @@
 #define UARTLOGGER_H_
 
 #include <inttypes.h>
-#include "msp.h"
+#include "hal.h"
+#include "ringBuffer.h"
+
+/* Logged bytes are copied into a RAM ring buffer and the eUSCI_A0 TX
+ * interrupt drains it, so logging never waits on the 9600 baud line. The
+ * game loop is the only producer, logging from an ISR is not supported */
+// log2 of the number of bytes the buffer holds
+#define UART_LOGGER_BUFFER_SIZE_LOG2 9
+
+RING_BUFFER_DECLARE(UartLoggerBuffer, uint8_t, UART_LOGGER_BUFFER_SIZE_LOG2)
+
+// Bytes waiting to be transmitted
+extern UartLoggerBuffer_t uartLoggerBuffer;
+// Number of bytes dropped because the buffer was full
+extern volatile uint32_t uartLoggerDroppedBytes;
 
 // Sends the NULL-terminated string str
 void UART_Logger_sendString(const char* str);
@@ -20,12 +34,41 @@ void UART_Logger_sendString(const char* str);
 void UART_Logger_sendBytes(uint8_t* byteArray, unsigned int length);
 // Sends the signed number in ASCII
 void UART_Logger_sendNumSigned(int32_t num);
+/* Sends a fixed-size binary record, the whole record is dropped and counted if
+ * it does not fit, so records are never cut short in the stream */
+void UART_Logger_sendRecord(const uint8_t* record, unsigned int length);
+/* Sleeps in LPM0 until the buffer has been sent, for output that does not fit
+ * in the buffer at once, interrupts must be enabled */
+void UART_Logger_flush();
 
-// Sends a single byte, blocks until transmitter is ready
-inline void UART_Logger_sendByte(uint8_t byte) {
-    while(EUSCI_A0->STATW & UCBUSY);
-    EUSCI_A0->TXBUF = byte;
+/* Queues a single byte, does not wait for the transmitter, the byte is
+ * dropped and counted if the buffer is full */
+static inline void UART_Logger_sendByte(uint8_t byte) {
+    if(!UartLoggerBuffer_push(&uartLoggerBuffer, &byte)) {
+        ++uartLoggerDroppedBytes;
+        return;
+    }
+    // Make sure the transmitter is draining the buffer
+    Hal_uartKick();
 }
 
+#ifdef HOST_BUILD
+/* Size of the host capture of the transmitted bytes, about 18 minutes of
+ * simulated time at 9600 baud */
+#define UART_LOGGER_HOST_CAPTURE_SIZE (1 << 20)
+
+// Bytes the host stand-in UART has transmitted
+extern uint8_t uartLoggerHostCapture[UART_LOGGER_HOST_CAPTURE_SIZE];
+// Number of bytes in the host capture
+extern uint32_t uartLoggerHostCaptureLength;
+
+/* Host stand-in for the TX interrupt, moves up to maxBytes from the buffer to
+ * the capture, returns the number of bytes moved, calling it with the number
+ * of bytes the line could have sent models the baud rate */
+uint32_t UART_Logger_hostTransmit(uint32_t maxBytes);
+// Empties the buffer and the capture and clears the dropped byte count
+void UART_Logger_hostReset();
+#endif
+
 #endif /* UARTLOGGER_H_ */
 #endif
@@ -31,6 +31,6 @@ void Vector2d_setDirection(Vector2d_t* self, double direction) {
     // Get the current magnitude
     double currentMagnitude = Vector2d_getMagnitude(self);
     // Compute the components using the magnitude and new direction
-    self->x = currentMagnitude * cos(direction);
-    self->y = currentMagnitude * sin(direction);
+    self->x = currentMagnitude * COUNTED_COS(direction);
+    self->y = currentMagnitude * COUNTED_SIN(direction);
 }
@@ -10,6 +10,7 @@
 
 #include <inttypes.h>
 #include <math.h>
+#include "counters.h"
 
 // Structure representing a 2-component vector
 typedef struct Vector2d {
@@ -18,35 +19,36 @@ typedef struct Vector2d {
 } Vector2d_t;
 
 // Computes and returns the magnitude of the given vector
-inline double Vector2d_getMagnitude(Vector2d_t* self) {
-    return sqrt((double)(self->x) * self->x + (double)(self->y) * self->y);
+static inline double Vector2d_getMagnitude(Vector2d_t* self) {
+    return COUNTED_SQRT((double)(self->x) * self->x +
+        (double)(self->y) * self->y);
 }
 
 // Sets the magnitude of the vector while retaining its direction
 void Vector2d_setMagnitude(Vector2d_t* self, double magnitude);
 
 // Computes and returns the direction of the vector
-inline double Vector2d_getDirection(Vector2d_t* self) {
-    return atan2(self->y, self->x);
+static inline double Vector2d_getDirection(Vector2d_t* self) {
+    return COUNTED_ATAN2(self->y, self->x);
 }
 
 // Set the direction of the vector while retaining its magnitude
 void Vector2d_setDirection(Vector2d_t* self, double direction);
 
 // Adds the given vector to self
-inline void Vector2d_selfAdd(Vector2d_t* self, const Vector2d_t* val) {
+static inline void Vector2d_selfAdd(Vector2d_t* self, const Vector2d_t* val) {
     self->x += val->x;
     self->y += val->y;
 }
 
 // Subtracts the given vector from self
-inline void Vector2d_selfSubtract(Vector2d_t* self, const Vector2d_t* val) {
+static inline void Vector2d_selfSubtract(Vector2d_t* self, const Vector2d_t* val) {
     self->x -= val->x;
     self->y -= val->y;
 }
 
 // Adds 2 vectors and returns the result
-inline Vector2d_t Vector2d_add(const Vector2d_t* a, const Vector2d_t* b) {
+static inline Vector2d_t Vector2d_add(const Vector2d_t* a, const Vector2d_t* b) {
     Vector2d_t sum;
     sum.x = a->x + b->x;
     sum.y = a->y + b->y;
@@ -54,11 +56,22 @@ inline Vector2d_t Vector2d_add(const Vector2d_t* a, const Vector2d_t* b) {
 }
 
 // Subtracts 2 vectors and returns the result
-inline Vector2d_t Vector2d_subtract(const Vector2d_t* a, const Vector2d_t* b) {
+static inline Vector2d_t Vector2d_subtract(const Vector2d_t* a, const Vector2d_t* b) {
     Vector2d_t difference;
     difference.x = a->x - b->x;
     difference.y = a->y - b->y;
     return difference;
 }
 
+// Multiplies self by the given scalar
+static inline void Vector2d_selfScale(Vector2d_t* self, double scalar) {
+    self->x *= scalar;
+    self->y *= scalar;
+}
+
+// Computes and returns the dot product of 2 vectors
+static inline double Vector2d_dot(const Vector2d_t* a, const Vector2d_t* b) {
+    return a->x * b->x + a->y * b->y;
+}
+
 #endif /* VECTOR2D_H_ */
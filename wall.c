@@ -9,11 +9,20 @@
 
 void Wall_init(Wall_t* self, double gapStartAngle, double gapEndAngle) {
     // Initializes the wall object
-    self->gapStartAngle = gapStartAngle;
-    self->gapEndAngle = gapEndAngle;
+    self->gapStartAngle[0] = gapStartAngle;
+    self->gapEndAngle[0] = gapEndAngle;
+    self->numGaps = 1;
     self->radius = WALL_INITIAL_RADIUS;
 }
 
+void Wall_addGap(Wall_t* self, double gapStartAngle, double gapEndAngle) {
+    if(self->numGaps < WALL_MAX_GAPS) {
+        self->gapStartAngle[self->numGaps] = gapStartAngle;
+        self->gapEndAngle[self->numGaps] = gapEndAngle;
+        ++self->numGaps;
+    }
+}
+
 void Wall_draw(Wall_t* self) {
     // Set the foreground color
     LCD_setForegroundColor(WALL_WALL_COLOR);
@@ -21,7 +30,10 @@ void Wall_draw(Wall_t* self) {
     LCD_drawCircle(WALL_CENTER_X, WALL_CENTER_Y, self->radius);
     // Set the background color
     LCD_setForegroundColor(WALL_GAP_COLOR);
-    // Draw the gap by drawing over the wall
-    LCD_drawArc(WALL_CENTER_X, WALL_CENTER_Y, self->radius,
-        self->gapStartAngle, self->gapEndAngle);
+    // Draw the gaps by drawing over the wall
+    uint8_t i;
+    for(i = 0; i < self->numGaps; ++i) {
+        LCD_drawArc(WALL_CENTER_X, WALL_CENTER_Y, self->radius,
+            self->gapStartAngle[i], self->gapEndAngle[i]);
+    }
 }
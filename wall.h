@@ -32,26 +32,49 @@
 // All walls' gaps will have this angular arc length
 #define WALL_GAP_ANGULAR_LENGTH CONSTANT_PI / 5
 
-// The rate at which walls spawn will be bounded by these values
-#define WALL_SPAWN_PERIOD_MAX 49152
-#define WALL_SPAWN_PERIOD_MIN 15152
-// Walls will spawn this many timer clock cycles faster after each one despawns
-#define WALL_SPAWN_PERIOD_DECREMENT 2000
+/* Stored walls use 16-bit binary angles: the whole int16_t range maps onto
+ * [-pi, pi), so angles wrap around the circle with plain integer overflow */
+typedef int16_t WallAngle_t;
+// Converts a binary angle to radians
+#define WALL_ANGLE_TO_RADIANS(angle) ((double)(angle) * (CONSTANT_PI / 32768.0))
+// The gap length as a binary angle (pi / 5)
+#define WALL_GAP_BINARY_LENGTH 6554
+/* Converts a gap position, in the interval
+ * [0, WALL_ANGLE_GENERATION_RESOLUTION), to the binary angle of the start of
+ * the gap */
+#define WALL_SECTOR_TO_ANGLE(sector) ((WallAngle_t)((sector) * \
+    (65536 / WALL_ANGLE_GENERATION_RESOLUTION) - 32768))
+
+/* The rate at which walls spawn will be bounded by these values, in
+ * simulation ticks (about 3 seconds down to about 1 second) */
+#define WALL_SPAWN_PERIOD_MAX 92
+#define WALL_SPAWN_PERIOD_MIN 28
+// Walls will spawn this many simulation ticks faster after each one despawns
+#define WALL_SPAWN_PERIOD_DECREMENT 4
+
+// Maximum number of gaps in a single wall
+#define WALL_MAX_GAPS 2
 
 #include <inttypes.h>
 
 typedef struct Wall {
-    // Gap bounds, gapStartAngle is always counter-clockwise of gapEndAngle
-    double gapStartAngle;
-    double gapEndAngle;
+    /* Gap bounds, each gapStartAngle is always counter-clockwise of its
+     * gapEndAngle */
+    double gapStartAngle[WALL_MAX_GAPS];
+    double gapEndAngle[WALL_MAX_GAPS];
+    // Number of gaps in use
+    uint8_t numGaps;
     // Current radius of the wall
     int16_t radius;
 } Wall_t;
 
-/* Initialize the wall with the given parameters, gapStartAngle must be
+/* Initialize the wall with a single gap, gapStartAngle must be
  * counter-clockwise of gapEndAngle, the angles are bounded in the interval
  * [-pi, pi] */
 void Wall_init(Wall_t* self, double gapStartAngle, double gapEndAngle);
+/* Adds another gap to the wall, the same rules as in Wall_init apply, extra
+ * gaps past WALL_MAX_GAPS are ignored */
+void Wall_addGap(Wall_t* self, double gapStartAngle, double gapEndAngle);
 // Draw the wall onto the LCD screen
 void Wall_draw(Wall_t* self);
 
@@ -7,61 +7,53 @@
 
 #include "wallBuffer.h"
 
-#include <stdlib.h>
+// Wraps a free-running index into the wall arrays
+#define WALL_INDEX(i) ((i) & RING_BUFFER_MASK(WALL_BUFFER_SIZE_LOG2))
 
-void WallBuffer_init(WallBuffer_t* self, uint32_t bufferSize) {
-    // Allocate the buffer array
-    self->buffer = malloc(sizeof(*self->buffer) * bufferSize);
-    // Set the buffer size
-    self->bufferSize = bufferSize;
+void WallBuffer_init(WallBuffer_t* self) {
     // Set the buffer to its initial state
-    self->numItems = 0;
-    self->head = self->buffer;
-    self->tail = self->buffer;
+    RingBufferIndex_init(&self->index);
+    self->tick = 0;
 }
 
-void WallBuffer_destroy(WallBuffer_t* self) {
-    // Free memory if not NULL
-    if(self->buffer) {
-        free((void*)self->buffer);
-        // Set the pointers to NULL
-        self->buffer = NULL;
-        self->head = NULL;
-        self->tail = NULL;
+WallBufferError_t WallBuffer_addWall(WallBuffer_t* self,
+    const WallAngle_t* gapStartAngles, uint8_t numGaps) {
+    uint32_t head;
+    // Check if the buffer is not at a full capacity
+    if(RingBufferIndex_reserve(&self->index, WALL_BUFFER_SIZE, &head)) {
+        if(numGaps > WALL_MAX_GAPS) {
+            numGaps = WALL_MAX_GAPS;
+        }
 
-        // Reset the size and numItems fields
-        self->bufferSize = 0;
-        self->numItems = 0;
-    }
-}
+        // Write the wall at the head
+        uint8_t i;
+        for(i = 0; i < numGaps; ++i) {
+            // The end angle wraps around to stay within [-pi, pi)
+            WallAngle_t gapEndAngle =
+                (WallAngle_t)(gapStartAngles[i] + WALL_GAP_BINARY_LENGTH);
 
-WallBufferError_t WallBuffer_addWall(WallBuffer_t* self, double startAngle,
-    double endAngle) {
-    // Check if the buffer is not at a full capacity
-    if(self->numItems < self->bufferSize) {
-        // Increment the number of items
-        ++self->numItems;
-        // Initialize the wall at the head
-        Wall_init((Wall_t*)self->head, startAngle, endAngle);
-        // Advance the head pointer by 1
-        advanceBufferPointer(self, (Wall_t**)&self->head);
+            self->gapStartAngle[i][WALL_INDEX(head)] = gapStartAngles[i];
+            self->gapStartRadians[i][WALL_INDEX(head)] =
+                WALL_ANGLE_TO_RADIANS(gapStartAngles[i]);
+            self->gapEndRadians[i][WALL_INDEX(head)] =
+                WALL_ANGLE_TO_RADIANS(gapEndAngle);
+        }
+        self->numGaps[WALL_INDEX(head)] = numGaps;
+        self->spawnTick[WALL_INDEX(head)] = self->tick;
+        // Publish the wall by advancing the head by 1
+        RingBufferIndex_publish(&self->index, 1);
         return WALL_BUFFER_NO_ERROR;
     }
 
     return WALL_BUFFER_OVERFLOW;
 }
 
-WallBufferError_t WallBuffer_removeWall(WallBuffer_t* self, Wall_t* removedItem) {
+WallBufferError_t WallBuffer_removeWall(WallBuffer_t* self) {
+    uint32_t tail;
     // Check if the buffer is not empty
-    if(self->numItems > 0) {
-        // Decrement the number of items
-        --self->numItems;
-        // Return the removed item, if necessary
-        if(removedItem) {
-            *removedItem = *self->tail;
-        }
-        // Advance the tail pointer by 1 array slot
-        advanceBufferPointer(self, (Wall_t**)&self->tail);
+    if(RingBufferIndex_acquire(&self->index, &tail)) {
+        // Release the slot by advancing the tail by 1
+        RingBufferIndex_release(&self->index, 1);
         return WALL_BUFFER_NO_ERROR;
     }
 
@@ -69,7 +61,13 @@ WallBufferError_t WallBuffer_removeWall(WallBuffer_t* self, Wall_t* removedItem)
 }
 
 void WallBuffer_emptyBuffer(WallBuffer_t* self) {
-    self->numItems = 0;
-    self->head = self->buffer;
-    self->tail = self->buffer;
+    // Release every published slot at once
+    RingBufferIndex_clear(&self->index);
+}
+
+void WallBuffer_takeSnapshot(WallBuffer_t* self, WallBufferSnapshot_t* snapshot) {
+    snapshot->buffer = self;
+    snapshot->numItems = RingBufferIndex_snapshot(&self->index,
+        &snapshot->tail);
+    snapshot->tick = self->tick;
 }
@@ -9,9 +9,11 @@
 #define WALLBUFFER_H_
 
 #include "wall.h"
+#include "ringBuffer.h"
 
-// Standard buffer size for the game
-#define WALL_BUFFER_SIZE 10
+// Standard buffer size for the game, as a power of two
+#define WALL_BUFFER_SIZE_LOG2 4
+#define WALL_BUFFER_SIZE RING_BUFFER_CAPACITY(WALL_BUFFER_SIZE_LOG2)
 
 // WallBuffer error codes
 typedef enum WallBufferError {
@@ -21,49 +23,95 @@ typedef enum WallBufferError {
     WALL_BUFFER_OVER_STEP = 3
 } WallBufferError_t;
 
-// Wall buffer structure, simply a circular queue that holds wall objects
+/* Wall buffer structure, a statically allocated single-producer/single-consumer
+ * circular queue of walls: walls are only added by the producer and only
+ * removed by the consumer, the indices are a RingBufferIndex_t so the two can
+ * live in different contexts (an ISR and the game loop).
+ *
+ * Walls are stored as a structure of arrays, a wall is its gap angles, both
+ * binary and converted to radians once when it is added so that drawing and
+ * collisions never convert them, and the tick it spawned on (38 bytes, 608
+ * for the 16 slots), its radius is derived from how many ticks it has been
+ * alive, so closing the walls in is a single tick increment */
 typedef struct WallBuffer {
-    // Array where data will be held
-    volatile Wall_t* buffer;
-
-    // Size of the arrray
-    volatile uint32_t bufferSize;
-    // Number of meaningful data items in the buffer
-    volatile uint32_t numItems;
-
-    /* Pointer to where items will be added, an item is added, then the
-     * pointer is advanced */
-    volatile Wall_t* head;
-    // Pointer to the oldest item
-    volatile Wall_t* tail;
+    // Gap start angles, each gap always spans WALL_GAP_BINARY_LENGTH
+    WallAngle_t gapStartAngle[WALL_MAX_GAPS][WALL_BUFFER_SIZE];
+    // The same gaps in radians, as Wall_t holds them
+    double gapStartRadians[WALL_MAX_GAPS][WALL_BUFFER_SIZE];
+    double gapEndRadians[WALL_MAX_GAPS][WALL_BUFFER_SIZE];
+    // Number of gaps in each wall
+    uint8_t numGaps[WALL_BUFFER_SIZE];
+    // Simulation tick each wall spawned on
+    uint8_t spawnTick[WALL_BUFFER_SIZE];
+
+    // Free-running head and tail of the walls
+    RingBufferIndex_t index;
+
+    /* Current simulation tick, only written by the consumer, a wall lives
+     * for far fewer than 256 ticks so the wrap-around does not matter */
+    volatile uint8_t tick;
 } WallBuffer_t;
 
-// Initialize a buffer with the given buffer size
-void WallBuffer_init(WallBuffer_t* self, uint32_t bufferSize);
-// Cleanup the array on the heap
-void WallBuffer_destroy(WallBuffer_t* self);
+/* Consumer-side copy of the buffer indices, the walls it covers belong to the
+ * consumer until they are removed, so they can be accessed without volatile
+ * qualifiers for the rest of the frame */
+typedef struct WallBufferSnapshot {
+    WallBuffer_t* buffer;
+    // Index of the oldest (inner-most) wall
+    uint32_t tail;
+    // Number of walls covered by the snapshot
+    uint32_t numItems;
+    // Tick the snapshot was taken on
+    uint8_t tick;
+} WallBufferSnapshot_t;
 
-// Adds a wall at the head given the start and end angles
-WallBufferError_t WallBuffer_addWall(WallBuffer_t* self, double startAngle,
-    double endAngle);
-/* Removes a wall from the tail and returns its value in the pointer given, a
- * NULL pointer can be passed in for removedItem */
-WallBufferError_t WallBuffer_removeWall(WallBuffer_t* self, Wall_t* removedItem);
+// Initialize a buffer to be empty
+void WallBuffer_init(WallBuffer_t* self);
 
-// Empties the contents of the buffer (does NOT free the array from the heap)
+/* Adds a wall at the head given the start angles of its gaps, it spawns on
+ * the current tick (producer only) */
+WallBufferError_t WallBuffer_addWall(WallBuffer_t* self,
+    const WallAngle_t* gapStartAngles, uint8_t numGaps);
+// Removes the oldest wall from the tail (consumer only)
+WallBufferError_t WallBuffer_removeWall(WallBuffer_t* self);
+
+// Empties the contents of the buffer (consumer only)
 void WallBuffer_emptyBuffer(WallBuffer_t* self);
 
-/* Function that advances a pointer pointing in the buffer by 1 array slot and
- * deals with wrap-around correctly */
-inline void advanceBufferPointer(WallBuffer_t* buffer, Wall_t** pointer) {
-    // Advance the pointer by 1 array slot
-    ++(*pointer);
-    /* Check if the pointer has surpassed the address of the last buffer array
-     * element */
-    if(*pointer > &buffer->buffer[buffer->bufferSize - 1]) {
-        // If it has, wrap it around to the start of the array
-        *pointer = (Wall_t*)buffer->buffer;
+/* Advances the simulation tick, this closes every wall in by WALL_SPEED
+ * (consumer only) */
+static inline void WallBuffer_advanceTick(WallBuffer_t* self) {
+    self->tick = self->tick + 1;
+}
+
+// Takes a snapshot of the walls currently in the buffer (consumer only)
+void WallBuffer_takeSnapshot(WallBuffer_t* self, WallBufferSnapshot_t* snapshot);
+
+/* Returns the radius of the i-th wall of a snapshot, starting from the
+ * oldest (inner-most) wall, i must be smaller than the snapshot's numItems */
+static inline int16_t WallBuffer_getSnapshotRadius(
+    WallBufferSnapshot_t* snapshot, uint32_t i) {
+    uint32_t index =
+        (snapshot->tail + i) & RING_BUFFER_MASK(WALL_BUFFER_SIZE_LOG2);
+    uint8_t age = snapshot->tick - snapshot->buffer->spawnTick[index];
+    return WALL_INITIAL_RADIUS - age * WALL_SPEED;
+}
+
+/* Fills in wall with the i-th wall of a snapshot so that it can be drawn or
+ * checked for collisions, i must be smaller than the snapshot's numItems */
+static inline void WallBuffer_getSnapshotWall(WallBufferSnapshot_t* snapshot,
+    uint32_t i, Wall_t* wall) {
+    uint32_t index =
+        (snapshot->tail + i) & RING_BUFFER_MASK(WALL_BUFFER_SIZE_LOG2);
+    WallBuffer_t* buffer = snapshot->buffer;
+
+    wall->numGaps = buffer->numGaps[index];
+    uint8_t gap;
+    for(gap = 0; gap < wall->numGaps; ++gap) {
+        wall->gapStartAngle[gap] = buffer->gapStartRadians[gap][index];
+        wall->gapEndAngle[gap] = buffer->gapEndRadians[gap][index];
     }
+    wall->radius = WallBuffer_getSnapshotRadius(snapshot, i);
 }
 
 #endif /* WALLBUFFER_H_ */